@@ -12,38 +12,57 @@ UAActorToGenerate::UAActorToGenerate()
 
 
 
-void UAActorToGenerate::GenerateMap(int NbRoom, TArray<FRoomType> RoomTypes)
+namespace
 {
-	float MaxProba = 0;
-	for (FRoomType& RoomType : RoomTypes)
+	void SpawnSampledRooms(int NbRoom, const TArray<FRoomType>& RoomTypes, const FDungeonRoomTypeSampler& Sampler)
 	{
-		MaxProba += RoomType.Probability;
-	}
-
-	TArray<ARoomParent*> SpawnedActors;
-	for (int i = 0; i < NbRoom; ++i)
-	{
-		float CurrentProba = FMath::FRandRange(0,MaxProba);
-		
-		float currentMaxProbability = 0;
-		FRoomType* RoomType = RoomTypes.FindByPredicate([CurrentProba, &currentMaxProbability](const FRoomType& Room){
-			currentMaxProbability += Room.Probability;
-			return CurrentProba < currentMaxProbability;
-		});
-
-		if (RoomType != nullptr){
-			AActor* SpawnedActorRaw = GWorld->SpawnActor(RoomType->TypeOfRoomToSpawn);
-			if (SpawnedActorRaw->IsA(ARoomParent::StaticClass()))
+		TArray<ARoomParent*> SpawnedActors;
+		for (int i = 0; i < NbRoom; ++i)
+		{
+			const int32 TypeId = Sampler.FindType(FMath::FRandRange(0, Sampler.GetTotalProbability()));
+			if (TypeId != INDEX_NONE)
 			{
-				SpawnedActors.Add(Cast<ARoomParent>(SpawnedActorRaw));
+				AActor* SpawnedActorRaw = GWorld->SpawnActor(RoomTypes[TypeId].TypeOfRoomToSpawn);
+				if (SpawnedActorRaw && SpawnedActorRaw->IsA(ARoomParent::StaticClass()))
+				{
+					SpawnedActors.Add(Cast<ARoomParent>(SpawnedActorRaw));
+				}
 			}
 		}
+
+		for (ARoomParent* SpawnedActor : SpawnedActors)
+		{
+			SpawnedActor->BoxCollision->SetSimulatePhysics(true);
+		}
+	}
+}
+
+void UAActorToGenerate::GenerateMap(int NbRoom, const TArray<FRoomType>& RoomTypes)
+{
+	FDungeonRoomTypeSampler Sampler;
+	for (const FRoomType& RoomType : RoomTypes)
+	{
+		Sampler.AddType(RoomType.Probability, RoomType.SizeMin, RoomType.SizeMax);
+	}
+	SpawnSampledRooms(NbRoom, RoomTypes, Sampler);
+}
+
+void UAActorToGenerate::GenerateMapFromConfig(int NbRoom, const UConfigRoomDataAsset* Config)
+{
+	if (!Config)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GenerateMapFromConfig needs a room config."));
+		return;
 	}
 
-	for (ARoomParent* SpawnedActor : SpawnedActors)
+	// Types added or removed at runtime without RebuildSampler, the built sampler would pick wrong indices
+	if (Config->GetSampler().NumTypes() != Config->RoomTypes.Num())
 	{
-		SpawnedActor->BoxCollision->SetSimulatePhysics(true);
+		UE_LOG(LogTemp, Warning, TEXT("Room config %s changed without RebuildSampler, sampling from a temporary one."), *Config->GetName());
+		GenerateMap(NbRoom, Config->RoomTypes);
+		return;
 	}
+	SpawnSampledRooms(NbRoom, Config->RoomTypes, Config->GetSampler());
 }
 
 void UAActorToGenerate::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent){
@@ -18,7 +18,11 @@ public:
 	UAActorToGenerate();
 
 	UFUNCTION(BlueprintCallable)
-	static void GenerateMap(int NbRoom, TArray<FRoomType> RoomTypes);
+	static void GenerateMap(int NbRoom, const TArray<FRoomType>& RoomTypes);
+
+	// Same as GenerateMap, reusing the room type sampler kept by the data asset
+	UFUNCTION(BlueprintCallable)
+	static void GenerateMapFromConfig(int NbRoom, const UConfigRoomDataAsset* Config);
 	
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 
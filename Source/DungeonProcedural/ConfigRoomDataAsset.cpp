@@ -0,0 +1,32 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/ConfigRoomDataAsset.h"
+
+void UConfigRoomDataAsset::RebuildSampler()
+{
+	Sampler.Reset();
+	for (const FRoomType& RoomType : RoomTypes)
+	{
+		Sampler.AddType(RoomType.Probability, RoomType.SizeMin, RoomType.SizeMax);
+	}
+}
+
+void UConfigRoomDataAsset::SampleRooms(const FRandomStream& Random, int32 NbRoom, TArray<int32>& OutTypeIds, TArray<FVector2f>& OutScales) const
+{
+	GetSampler().SampleRooms(Random, NbRoom, OutTypeIds, OutScales);
+}
+
+void UConfigRoomDataAsset::PostLoad()
+{
+	Super::PostLoad();
+	RebuildSampler();
+}
+
+#if WITH_EDITOR
+void UConfigRoomDataAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	RebuildSampler();
+}
+#endif
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonRoomSampler.h"
 #include "DungeonProcedural/RoomParent.h"
 #include "Engine/DataAsset.h"
 #include "ConfigRoomDataAsset.generated.h"
@@ -42,4 +43,22 @@ public:
 	// Array of available room types for procedural generation
 	UPROPERTY(EditAnywhere,BlueprintReadWrite)
 	TArray<FRoomType> RoomTypes;
+
+	// Weighted picker over RoomTypes, built on load and on edit only, so reading it from any thread is safe
+	// Call RebuildSampler on the game thread after changing RoomTypes at runtime.
+	const FDungeonRoomTypeSampler& GetSampler() const { return Sampler; }
+
+	UFUNCTION(BlueprintCallable)
+	void RebuildSampler();
+
+	// Types and scales of NbRoom rooms in one pass, indices refer to RoomTypes
+	void SampleRooms(const FRandomStream& Random, int32 NbRoom, TArray<int32>& OutTypeIds, TArray<FVector2f>& OutScales) const;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	FDungeonRoomTypeSampler Sampler;
 };
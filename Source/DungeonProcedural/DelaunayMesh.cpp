@@ -0,0 +1,310 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DelaunayMesh.h"
+
+#include "Algo/StableSort.h"
+#include "DungeonProcedural/DungeonArena.h"
+#include "DungeonProcedural/DungeonStats.h"
+#include "DungeonProcedural/GeometryPredicates.h"
+
+namespace
+{
+	// Position along a Hilbert curve of a point on a 65536 x 65536 grid
+	uint64 HilbertIndex(uint32 X, uint32 Y)
+	{
+		constexpr uint32 GridSize = 1u << 16;
+		uint64 Index = 0;
+		for (uint32 S = GridSize / 2; S > 0; S /= 2)
+		{
+			const uint32 RX = (X & S) > 0 ? 1 : 0;
+			const uint32 RY = (Y & S) > 0 ? 1 : 0;
+			Index += uint64(S) * uint64(S) * uint64((3 * RX) ^ RY);
+
+			// Rotate the quadrant
+			if (RY == 0)
+			{
+				if (RX == 1)
+				{
+					X = GridSize - 1 - X;
+					Y = GridSize - 1 - Y;
+				}
+				Swap(X, Y);
+			}
+		}
+		return Index;
+	}
+}
+
+void FDelaunayMesh::Init(const FVector2D& SuperA, const FVector2D& SuperB, const FVector2D& SuperC, int32 ExpectedPoints)
+{
+	Vertices.Reset(ExpectedPoints + NumSuperVertices);
+	Triangles.Reset(2 * ExpectedPoints + 1);
+	FreeTriangles.Reset();
+	NewTriangleByVertex.Reset(ExpectedPoints + NumSuperVertices);
+	InCavity.Reset(2 * ExpectedPoints + 1);
+	Counters = FCounters();
+
+	// Keep the super-triangle counter-clockwise
+	Vertices.Add(SuperA);
+	if (FGeometryPredicates::Orient2D(SuperA, SuperB, SuperC) >= 0)
+	{
+		Vertices.Add(SuperB);
+		Vertices.Add(SuperC);
+	}
+	else
+	{
+		Vertices.Add(SuperC);
+		Vertices.Add(SuperB);
+	}
+	NewTriangleByVertex.Init(INDEX_NONE, NumSuperVertices);
+
+	LastTriangle = AllocateTriangle();
+	FMeshTriangle& Super = Triangles[LastTriangle];
+	for (int32 i = 0; i < 3; ++i)
+	{
+		Super.V[i] = i;
+		Super.N[i] = INDEX_NONE;
+	}
+}
+
+int32 FDelaunayMesh::Insert(const FVector2D& Point)
+{
+	const int32 Start = LocateTriangle(Point);
+	if (Start == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	// Duplicated point: reuse the existing vertex
+	for (int32 i = 0; i < 3; ++i)
+	{
+		if (Vertices[Triangles[Start].V[i]] == Point)
+		{
+			return Triangles[Start].V[i];
+		}
+	}
+
+	const int32 NewVertex = Vertices.Add(Point);
+	NewTriangleByVertex.Add(INDEX_NONE);
+
+	// Grow the cavity from the containing triangle through neighbors whose circumcircle contains the point
+	Cavity.Reset();
+	Stack.Reset();
+	Stack.Add(Start);
+	InCavity[Start] = true;
+	while (Stack.Num() > 0)
+	{
+		const int32 Current = Stack.Pop(EAllowShrinking::No);
+		Cavity.Add(Current);
+		for (int32 i = 0; i < 3; ++i)
+		{
+			const int32 Neighbor = Triangles[Current].N[i];
+			if (Neighbor != INDEX_NONE && !InCavity[Neighbor])
+			{
+				++Counters.InCircleTests;
+				if (IsInCircumcircle(Neighbor, Point))
+				{
+					InCavity[Neighbor] = true;
+					Stack.Add(Neighbor);
+				}
+			}
+		}
+	}
+
+	// Cavity boundary: edges whose other side is not in the cavity
+	Boundary.Reset();
+	for (int32 TriangleIndex : Cavity)
+	{
+		const FMeshTriangle& Tri = Triangles[TriangleIndex];
+		for (int32 i = 0; i < 3; ++i)
+		{
+			if (Tri.N[i] == INDEX_NONE || !InCavity[Tri.N[i]])
+			{
+				Boundary.Add({Tri.V[(i + 1) % 3], Tri.V[(i + 2) % 3], Tri.N[i]});
+			}
+		}
+	}
+
+	for (int32 TriangleIndex : Cavity)
+	{
+		InCavity[TriangleIndex] = false;
+		Triangles[TriangleIndex].V[0] = INDEX_NONE;
+		FreeTriangles.Add(TriangleIndex);
+	}
+
+	Counters.TrianglesRemoved += Cavity.Num();
+	Counters.TrianglesCreated += Boundary.Num();
+
+	// Fan the boundary around the new point
+	for (const FBoundaryEdge& Edge : Boundary)
+	{
+		const int32 NewTriangle = AllocateTriangle();
+		FMeshTriangle& Tri = Triangles[NewTriangle];
+		Tri.V[0] = NewVertex;
+		Tri.V[1] = Edge.A;
+		Tri.V[2] = Edge.B;
+		Tri.N[0] = Edge.Outside;
+		Tri.N[1] = INDEX_NONE;
+		Tri.N[2] = INDEX_NONE;
+
+		// The outside triangle stores the same edge as B->A
+		if (Edge.Outside != INDEX_NONE)
+		{
+			FMeshTriangle& Outside = Triangles[Edge.Outside];
+			for (int32 i = 0; i < 3; ++i)
+			{
+				if (Outside.V[(i + 1) % 3] == Edge.B && Outside.V[(i + 2) % 3] == Edge.A)
+				{
+					Outside.N[i] = NewTriangle;
+					break;
+				}
+			}
+		}
+
+		NewTriangleByVertex[Edge.A] = NewTriangle;
+		LastTriangle = NewTriangle;
+	}
+
+	// Triangle (P, A, B) shares the edge B->P with the triangle starting at B
+	for (const FBoundaryEdge& Edge : Boundary)
+	{
+		const int32 Current = NewTriangleByVertex[Edge.A];
+		const int32 Next = NewTriangleByVertex[Edge.B];
+		Triangles[Current].N[1] = Next;
+		Triangles[Next].N[2] = Current;
+	}
+	for (const FBoundaryEdge& Edge : Boundary)
+	{
+		NewTriangleByVertex[Edge.A] = INDEX_NONE;
+	}
+
+	return NewVertex;
+}
+
+void FDelaunayMesh::GetTriangles(TArray<FIntVector>& OutTriangles) const
+{
+	OutTriangles.Reset(Triangles.Num() - FreeTriangles.Num());
+	for (const FMeshTriangle& Tri : Triangles)
+	{
+		if (Tri.IsAlive() && Tri.V[0] >= NumSuperVertices && Tri.V[1] >= NumSuperVertices && Tri.V[2] >= NumSuperVertices)
+		{
+			OutTriangles.Add(FIntVector(Tri.V[0] - NumSuperVertices, Tri.V[1] - NumSuperVertices, Tri.V[2] - NumSuperVertices));
+		}
+	}
+}
+
+void FDelaunayMesh::PublishCounters(const FCounters& InCounters)
+{
+	INC_DWORD_STAT_BY(STAT_DungeonInCircleTests, InCounters.InCircleTests);
+	INC_DWORD_STAT_BY(STAT_DungeonTrianglesCreated, InCounters.TrianglesCreated);
+	INC_DWORD_STAT_BY(STAT_DungeonTrianglesRemoved, InCounters.TrianglesRemoved);
+}
+
+void FDelaunayMesh::SortForInsertion(TConstArrayView<FVector2D> Points, TArray<int32>& OutOrder)
+{
+	FDungeonArena Scratch;
+	SortForInsertion(Points, OutOrder, Scratch);
+}
+
+void FDelaunayMesh::SortForInsertion(TConstArrayView<FVector2D> Points, TArray<int32>& OutOrder, FDungeonArena& Scratch)
+{
+	OutOrder.SetNumUninitialized(Points.Num());
+	if (Points.Num() == 0)
+	{
+		return;
+	}
+
+	FBox2D Bounds(Points.GetData(), Points.Num());
+	const FVector2D Size = Bounds.GetSize();
+	const double Scale = 65535.0 / FMath::Max(FMath::Max(Size.X, Size.Y), UE_DOUBLE_SMALL_NUMBER);
+
+	const FDungeonArena::FMark Mark(Scratch);
+	TArrayView<uint64> Keys = Scratch.AllocateArray<uint64>(Points.Num());
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		const FVector2D Cell = (Points[i] - Bounds.Min) * Scale;
+		Keys[i] = HilbertIndex(uint32(Cell.X), uint32(Cell.Y));
+		OutOrder[i] = i;
+	}
+
+	// Stable so points sharing a cell keep their original order
+	Algo::StableSortBy(OutOrder, [&Keys](int32 Index) { return Keys[Index]; });
+}
+
+void FDelaunayMesh::ComputeSuperTriangle(TConstArrayView<FVector2D> Points, FVector2D& OutA, FVector2D& OutB, FVector2D& OutC)
+{
+	FBox2D Bounds(Points.GetData(), Points.Num());
+	const FVector2D Avg = Bounds.GetCenter();
+	const double DifX = FMath::Max(Bounds.GetExtent().X, 1.0);
+	const double DifY = FMath::Max(Bounds.GetExtent().Y, 1.0);
+
+	OutA = FVector2D(Avg.X, Avg.Y + DifY * 10);
+	OutB = FVector2D(Avg.X - DifX * 5, Avg.Y - DifY * 5);
+	OutC = FVector2D(Avg.X + DifX * 5, Avg.Y - DifY * 5);
+}
+
+int32 FDelaunayMesh::LocateTriangle(const FVector2D& Point) const
+{
+	int32 Current = LastTriangle;
+
+	// Visibility walk: cross any edge that has the point on its outer side
+	// The first tested edge rotates each step so the walk cannot cycle
+	const int32 MaxSteps = Triangles.Num() + 3;
+	for (int32 Step = 0; Step < MaxSteps; ++Step)
+	{
+		const FMeshTriangle& Tri = Triangles[Current];
+		int32 Next = Current;
+		for (int32 k = 0; k < 3; ++k)
+		{
+			const int32 i = (k + Step) % 3;
+			if (FGeometryPredicates::Orient2D(Vertices[Tri.V[(i + 1) % 3]], Vertices[Tri.V[(i + 2) % 3]], Point) < 0)
+			{
+				Next = Tri.N[i];
+				break;
+			}
+		}
+
+		if (Next == Current)
+		{
+			return Current;
+		}
+		if (Next == INDEX_NONE)
+		{
+			// Outside of the super-triangle
+			return INDEX_NONE;
+		}
+		Current = Next;
+	}
+
+	// Should never happen on a valid Delaunay mesh, fall back to a linear search
+	for (int32 TriangleIndex = 0; TriangleIndex < Triangles.Num(); ++TriangleIndex)
+	{
+		const FMeshTriangle& Tri = Triangles[TriangleIndex];
+		if (Tri.IsAlive()
+			&& FGeometryPredicates::Orient2D(Vertices[Tri.V[0]], Vertices[Tri.V[1]], Point) >= 0
+			&& FGeometryPredicates::Orient2D(Vertices[Tri.V[1]], Vertices[Tri.V[2]], Point) >= 0
+			&& FGeometryPredicates::Orient2D(Vertices[Tri.V[2]], Vertices[Tri.V[0]], Point) >= 0)
+		{
+			return TriangleIndex;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool FDelaunayMesh::IsInCircumcircle(int32 TriangleIndex, const FVector2D& Point) const
+{
+	const FMeshTriangle& Tri = Triangles[TriangleIndex];
+	return FGeometryPredicates::InCircle(Vertices[Tri.V[0]], Vertices[Tri.V[1]], Vertices[Tri.V[2]], Point) > 0;
+}
+
+int32 FDelaunayMesh::AllocateTriangle()
+{
+	if (FreeTriangles.Num() > 0)
+	{
+		return FreeTriangles.Pop(EAllowShrinking::No);
+	}
+
+	InCavity.Add(false);
+	return Triangles.AddUninitialized();
+}
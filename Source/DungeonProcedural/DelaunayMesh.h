@@ -0,0 +1,99 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FDungeonArena;
+
+// Index-based incremental Delaunay triangulation
+// Triangles are stored counter-clockwise with their three neighbors, so inserting
+// a point walks to its containing triangle and only rebuilds the local cavity.
+// Vertices 0, 1 and 2 are the super-triangle, inserted points start at index 3.
+class DUNGEONPROCEDURAL_API FDelaunayMesh
+{
+public:
+	static constexpr int32 NumSuperVertices = 3;
+
+	struct FMeshTriangle
+	{
+		// Vertices in counter-clockwise order
+		int32 V[3];
+
+		// N[i] is the triangle across the edge opposite to V[i], INDEX_NONE on the hull
+		int32 N[3];
+
+		bool IsAlive() const { return V[0] != INDEX_NONE; }
+	};
+
+	// Work done since Init, published to the Dungeon stats by the owner
+	struct FCounters
+	{
+		int32 InCircleTests = 0;
+		int32 TrianglesCreated = 0;
+		int32 TrianglesRemoved = 0;
+
+		FCounters& operator+=(const FCounters& Other)
+		{
+			InCircleTests += Other.InCircleTests;
+			TrianglesCreated += Other.TrianglesCreated;
+			TrianglesRemoved += Other.TrianglesRemoved;
+			return *this;
+		}
+	};
+
+	// Starts a new triangulation inside the given super-triangle
+	void Init(const FVector2D& SuperA, const FVector2D& SuperB, const FVector2D& SuperC, int32 ExpectedPoints = 0);
+
+	// Inserts a point and returns its vertex index
+	// Returns INDEX_NONE if the point lies outside the super-triangle
+	int32 Insert(const FVector2D& Point);
+
+	// Alive triangles that do not touch the super-triangle
+	// Vertex indices are shifted so the first inserted point is 0
+	void GetTriangles(TArray<FIntVector>& OutTriangles) const;
+
+	int32 NumVertices() const { return Vertices.Num(); }
+	const FVector2D& GetVertex(int32 VertexIndex) const { return Vertices[VertexIndex]; }
+	const TArray<FMeshTriangle>& GetMeshTriangles() const { return Triangles; }
+	const FCounters& GetCounters() const { return Counters; }
+
+	// Adds the counters to the Dungeon stats
+	static void PublishCounters(const FCounters& InCounters);
+
+	// Insertion order following a Hilbert curve, keeps point location walks short
+	static void SortForInsertion(TConstArrayView<FVector2D> Points, TArray<int32>& OutOrder);
+
+	// Same, with the curve keys taken from Scratch
+	static void SortForInsertion(TConstArrayView<FVector2D> Points, TArray<int32>& OutOrder, FDungeonArena& Scratch);
+
+	// Super-triangle used by URoomManager::MegaTriangle around the given points
+	static void ComputeSuperTriangle(TConstArrayView<FVector2D> Points, FVector2D& OutA, FVector2D& OutB, FVector2D& OutC);
+
+private:
+	// Walks from the last created triangle to the one containing Point
+	int32 LocateTriangle(const FVector2D& Point) const;
+
+	bool IsInCircumcircle(int32 TriangleIndex, const FVector2D& Point) const;
+
+	int32 AllocateTriangle();
+
+	TArray<FVector2D> Vertices;
+	TArray<FMeshTriangle> Triangles;
+	TArray<int32> FreeTriangles;
+	int32 LastTriangle = INDEX_NONE;
+	FCounters Counters;
+
+	// Scratch buffers reused across insertions
+	TArray<int32> Cavity;
+	TArray<int32> Stack;
+	TArray<bool> InCavity;
+	TArray<int32> NewTriangleByVertex;
+	struct FBoundaryEdge
+	{
+		int32 A;
+		int32 B;
+		int32 Outside;
+	};
+	TArray<FBoundaryEdge> Boundary;
+};
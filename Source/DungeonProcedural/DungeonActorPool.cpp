@@ -0,0 +1,145 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonActorPool.h"
+
+#include "DungeonProcedural/DungeonStats.h"
+#include "Engine/World.h"
+
+namespace
+{
+	// Tag carried by free actors, cheap to test from any world query
+	const FName PooledTag(TEXT("DungeonPooled"));
+
+	void Deactivate(AActor* Actor)
+	{
+		Actor->SetActorHiddenInGame(true);
+		Actor->SetActorEnableCollision(false);
+		Actor->SetActorTickEnabled(false);
+		Actor->Tags.AddUnique(PooledTag);
+	}
+}
+
+AActor* FDungeonActorPool::Acquire(UWorld* World, TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation)
+{
+	if (!ActorClass)
+	{
+		return nullptr;
+	}
+
+	if (FDungeonActorPoolBucket* Bucket = Buckets.Find(ActorClass.Get()))
+	{
+		while (Bucket->FreeActors.Num() > 0)
+		{
+			AActor* Actor = Bucket->FreeActors.Pop(EAllowShrinking::No);
+			if (!IsValid(Actor))
+			{
+				continue;
+			}
+
+			// Scale goes back to the class default, callers that stretch only one axis keep the others
+			Actor->Tags.Remove(PooledTag);
+			Actor->SetActorScale3D(Actor->GetClass()->GetDefaultObject<AActor>()->GetActorScale3D());
+			Actor->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+			Actor->SetActorHiddenInGame(false);
+			Actor->SetActorEnableCollision(true);
+			Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+			++NumActive;
+			++NumReused;
+			INC_DWORD_STAT(STAT_DungeonActorsReused);
+			return Actor;
+		}
+	}
+
+	AActor* Actor = Spawn(World, ActorClass, Location, Rotation);
+	if (Actor)
+	{
+		++NumActive;
+	}
+	return Actor;
+}
+
+void FDungeonActorPool::Release(AActor* Actor)
+{
+	if (!IsValid(Actor) || IsPooled(Actor))
+	{
+		return;
+	}
+
+	Deactivate(Actor);
+	Buckets.FindOrAdd(Actor->GetClass()).FreeActors.Add(Actor);
+	NumActive = FMath::Max(NumActive - 1, 0);
+}
+
+void FDungeonActorPool::Prewarm(UWorld* World, TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	if (!ActorClass)
+	{
+		return;
+	}
+
+	TArray<AActor*>& FreeActors = Buckets.FindOrAdd(ActorClass.Get()).FreeActors;
+	FreeActors.RemoveAll([](const AActor* Actor) { return !IsValid(Actor); });
+	FreeActors.Reserve(Count);
+	while (FreeActors.Num() < Count)
+	{
+		AActor* Actor = Spawn(World, ActorClass, FVector::ZeroVector, FRotator::ZeroRotator);
+		if (!Actor)
+		{
+			break;
+		}
+		Deactivate(Actor);
+		FreeActors.Add(Actor);
+	}
+}
+
+void FDungeonActorPool::Empty()
+{
+	for (TPair<UClass*, FDungeonActorPoolBucket>& Pair : Buckets)
+	{
+		for (AActor* Actor : Pair.Value.FreeActors)
+		{
+			if (IsValid(Actor))
+			{
+				Actor->Destroy();
+			}
+		}
+	}
+	Buckets.Empty();
+}
+
+FDungeonActorPoolStats FDungeonActorPool::GetStats() const
+{
+	FDungeonActorPoolStats Stats;
+	Stats.NumActive = NumActive;
+	Stats.NumSpawned = NumSpawned;
+	Stats.NumReused = NumReused;
+	for (const TPair<UClass*, FDungeonActorPoolBucket>& Pair : Buckets)
+	{
+		Stats.NumFree += Pair.Value.FreeActors.Num();
+	}
+	return Stats;
+}
+
+bool FDungeonActorPool::IsPooled(const AActor* Actor)
+{
+	return Actor && Actor->Tags.Contains(PooledTag);
+}
+
+AActor* FDungeonActorPool::Spawn(UWorld* World, TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AActor* Actor = World->SpawnActor<AActor>(ActorClass, Location, Rotation, SpawnParams);
+	if (Actor)
+	{
+		++NumSpawned;
+		INC_DWORD_STAT(STAT_DungeonActorsSpawned);
+	}
+	return Actor;
+}
@@ -0,0 +1,81 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "DungeonActorPool.generated.h"
+
+// Pool counters, totals over every class
+USTRUCT(BlueprintType)
+struct FDungeonActorPoolStats
+{
+	GENERATED_BODY()
+
+	// Actors currently handed out by Acquire
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Pool")
+	int32 NumActive = 0;
+
+	// Hidden actors waiting for reuse
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Pool")
+	int32 NumFree = 0;
+
+	// Actors spawned by the pool, pre-warm included
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Pool")
+	int32 NumSpawned = 0;
+
+	// Acquire calls served without spawning
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Pool")
+	int32 NumReused = 0;
+};
+
+// Free actors of one class
+USTRUCT()
+struct FDungeonActorPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> FreeActors;
+};
+
+// Keeps released actors hidden in the world instead of destroying them
+// Actors are keyed by their exact class, so a room Blueprint only ever reuses its own instances.
+USTRUCT()
+struct DUNGEONPROCEDURAL_API FDungeonActorPool
+{
+	GENERATED_BODY()
+
+	// Reuses a free actor of this class or spawns a new one, then places it at the class default scale
+	AActor* Acquire(UWorld* World, TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation);
+
+	template<typename T>
+	T* Acquire(UWorld* World, TSubclassOf<T> ActorClass, const FVector& Location, const FRotator& Rotation)
+	{
+		return Cast<T>(Acquire(World, TSubclassOf<AActor>(ActorClass), Location, Rotation));
+	}
+
+	// Hides the actor, disables its collision and tick, and keeps it for a later Acquire
+	void Release(AActor* Actor);
+
+	// Spawns hidden actors until at least Count of this class are free
+	void Prewarm(UWorld* World, TSubclassOf<AActor> ActorClass, int32 Count);
+
+	// Destroys every free actor, active ones are left untouched
+	void Empty();
+
+	FDungeonActorPoolStats GetStats() const;
+
+	// True if the actor is hidden in a pool, such actors must be skipped by world queries
+	static bool IsPooled(const AActor* Actor);
+
+private:
+	AActor* Spawn(UWorld* World, TSubclassOf<AActor> ActorClass, const FVector& Location, const FRotator& Rotation);
+
+	UPROPERTY()
+	TMap<UClass*, FDungeonActorPoolBucket> Buckets;
+
+	int32 NumActive = 0;
+	int32 NumSpawned = 0;
+	int32 NumReused = 0;
+};
@@ -0,0 +1,126 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonArena.h"
+
+namespace
+{
+	constexpr SIZE_T BlockAlignment = 16;
+}
+
+FDungeonArena::~FDungeonArena()
+{
+	Empty();
+}
+
+void* FDungeonArena::Allocate(SIZE_T Size, SIZE_T Alignment)
+{
+	if (Size == 0)
+	{
+		return nullptr;
+	}
+
+	// Current block first, then the blocks kept from earlier runs, then a new one
+	while (true)
+	{
+		if (CurrentBlock >= 0)
+		{
+			FBlock& Block = Blocks[CurrentBlock];
+			const SIZE_T Offset = Align(Block.Used, Alignment);
+			if (Offset + Size <= Block.Size)
+			{
+				UsedBytes += Offset + Size - Block.Used;
+				HighWaterBytes = FMath::Max(HighWaterBytes, UsedBytes);
+				Block.Used = Offset + Size;
+				return Block.Data + Offset;
+			}
+		}
+
+		if (CurrentBlock + 1 < Blocks.Num())
+		{
+			++CurrentBlock;
+			Blocks[CurrentBlock].Used = 0;
+		}
+		else
+		{
+			AddBlock(Size + Alignment);
+		}
+	}
+}
+
+void FDungeonArena::Reserve(SIZE_T Size)
+{
+	// Allocate moves on to the next block once the current one is full, so either of them will do
+	const bool bFitsCurrent = CurrentBlock >= 0 && Blocks[CurrentBlock].Size - Blocks[CurrentBlock].Used >= Size;
+	const bool bFitsNext = CurrentBlock + 1 < Blocks.Num() && Blocks[CurrentBlock + 1].Size >= Size;
+	if (!bFitsCurrent && !bFitsNext)
+	{
+		AddBlock(Size);
+	}
+}
+
+void FDungeonArena::Reset()
+{
+	if (Blocks.Num() > 1)
+	{
+		// Merge so the next run of this size fits in one block
+		const SIZE_T Capacity = GetCapacity();
+		Empty();
+		AddBlock(Capacity);
+	}
+
+	for (FBlock& Block : Blocks)
+	{
+		Block.Used = 0;
+	}
+	CurrentBlock = Blocks.Num() > 0 ? 0 : INDEX_NONE;
+	UsedBytes = 0;
+}
+
+void FDungeonArena::Empty()
+{
+	for (FBlock& Block : Blocks)
+	{
+		FMemory::Free(Block.Data);
+	}
+	Blocks.Reset();
+	CurrentBlock = INDEX_NONE;
+	UsedBytes = 0;
+}
+
+SIZE_T FDungeonArena::GetCapacity() const
+{
+	SIZE_T Capacity = 0;
+	for (const FBlock& Block : Blocks)
+	{
+		Capacity += Block.Size;
+	}
+	return Capacity;
+}
+
+void FDungeonArena::AddBlock(SIZE_T Size)
+{
+	// Geometric growth keeps the number of blocks logarithmic in the scratch size
+	const SIZE_T LastSize = Blocks.Num() > 0 ? Blocks.Last().Size : 0;
+	FBlock Block;
+	Block.Size = Align(FMath::Max3(Size, MinBlockSize, 2 * LastSize), BlockAlignment);
+	Block.Data = static_cast<uint8*>(FMemory::Malloc(Block.Size, BlockAlignment));
+	Blocks.Add(Block);
+	++NumBlockAllocations;
+
+	// Blocks after the current one are spares, a new block goes right after it
+	if (CurrentBlock + 1 != Blocks.Num() - 1)
+	{
+		Blocks.Swap(CurrentBlock + 1, Blocks.Num() - 1);
+	}
+}
+
+void FDungeonArena::PopTo(int32 BlockIndex, SIZE_T BlockUsed, SIZE_T InUsedBytes)
+{
+	CurrentBlock = BlockIndex;
+	if (CurrentBlock >= 0)
+	{
+		Blocks[CurrentBlock].Used = BlockUsed;
+	}
+	UsedBytes = InUsedBytes;
+}
@@ -0,0 +1,96 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Linear allocator for the scratch buffers of one generation
+// Allocations bump a pointer inside large blocks and are only released all at once,
+// by Reset or by an FMark going out of scope. Reset keeps the memory, so a generator
+// reused for runs of the same size does not touch the heap again.
+// Not thread-safe, each generator owns its own arena.
+class DUNGEONPROCEDURAL_API FDungeonArena
+{
+public:
+	// Blocks are never smaller than this
+	static constexpr SIZE_T MinBlockSize = 64 * 1024;
+
+	FDungeonArena() = default;
+	~FDungeonArena();
+	FDungeonArena(const FDungeonArena&) = delete;
+	FDungeonArena& operator=(const FDungeonArena&) = delete;
+
+	// Uninitialized memory, valid until the arena is reset past it
+	void* Allocate(SIZE_T Size, SIZE_T Alignment);
+
+	// Uninitialized array, elements are never destroyed
+	template<typename ElementType>
+	TArrayView<ElementType> AllocateArray(int32 Num)
+	{
+		static_assert(std::is_trivially_destructible_v<ElementType>, "Arena memory is released without calling destructors");
+		return TArrayView<ElementType>(static_cast<ElementType*>(Allocate(sizeof(ElementType) * FMath::Max(Num, 0), alignof(ElementType))), FMath::Max(Num, 0));
+	}
+
+	// Makes sure the next allocations of up to Size bytes fit without a new block
+	void Reserve(SIZE_T Size);
+
+	// Releases every allocation
+	// If the last run spilled over several blocks they are merged into a single one large enough for it.
+	void Reset();
+
+	// Frees the blocks as well
+	void Empty();
+
+	// Bytes handed out since the last Reset, alignment padding included
+	SIZE_T GetUsedBytes() const { return UsedBytes; }
+
+	// Largest GetUsedBytes seen since construction
+	SIZE_T GetHighWaterBytes() const { return HighWaterBytes; }
+
+	// Total size of the blocks currently held
+	SIZE_T GetCapacity() const;
+
+	// Number of blocks allocated from the heap since construction
+	int32 GetNumBlockAllocations() const { return NumBlockAllocations; }
+
+	// Releases everything allocated after its construction when it goes out of scope
+	class FMark
+	{
+	public:
+		explicit FMark(FDungeonArena& InArena)
+			: Arena(InArena), BlockIndex(InArena.CurrentBlock), BlockUsed(InArena.CurrentBlock >= 0 ? InArena.Blocks[InArena.CurrentBlock].Used : 0), UsedBytes(InArena.UsedBytes)
+		{
+		}
+
+		~FMark() { Arena.PopTo(BlockIndex, BlockUsed, UsedBytes); }
+
+		FMark(const FMark&) = delete;
+		FMark& operator=(const FMark&) = delete;
+
+	private:
+		FDungeonArena& Arena;
+		int32 BlockIndex;
+		SIZE_T BlockUsed;
+		SIZE_T UsedBytes;
+	};
+
+private:
+	struct FBlock
+	{
+		uint8* Data = nullptr;
+		SIZE_T Size = 0;
+		SIZE_T Used = 0;
+	};
+
+	void AddBlock(SIZE_T Size);
+	void PopTo(int32 BlockIndex, SIZE_T BlockUsed, SIZE_T InUsedBytes);
+
+	TArray<FBlock, TInlineAllocator<4>> Blocks;
+
+	// Block allocations are taken from, INDEX_NONE before the first one
+	int32 CurrentBlock = INDEX_NONE;
+
+	SIZE_T UsedBytes = 0;
+	SIZE_T HighWaterBytes = 0;
+	int32 NumBlockAllocations = 0;
+};
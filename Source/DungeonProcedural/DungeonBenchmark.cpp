@@ -0,0 +1,312 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonBenchmark.h"
+
+#include <atomic>
+
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "DungeonProcedural/RoomManager.h"
+#include "DungeonProcedural/Triangle.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "HAL/PlatformProperties.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+// Carried by every measured stage, so the tracker reports the heap of the stages only
+LLM_DEFINE_TAG(DungeonBenchmark);
+#endif
+
+namespace
+{
+#if STATS
+	// FMalloc keeps its call counters protected, this type only reads them and is never instantiated
+	struct FMallocCallCounters : FMalloc
+	{
+		static int64 GetNumAllocations()
+		{
+			return int64(TotalMallocCalls.load(std::memory_order_relaxed) + TotalReallocCalls.load(std::memory_order_relaxed));
+		}
+	};
+#endif
+
+	// Heap counters read around a stage, nothing is hooked into the allocator so the timings are not affected
+	// A counter that is not compiled in, or LLM without -llm, stays at -1.
+	struct FHeapCounters
+	{
+		int64 NumAllocations = -1;
+		int64 TaggedBytes = -1;
+		int64 TaggedPeakBytes = -1;
+
+		static FHeapCounters Read()
+		{
+			FHeapCounters Counters;
+#if STATS
+			Counters.NumAllocations = FMallocCallCounters::GetNumAllocations();
+#endif
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+			if (FLowLevelMemTracker::IsEnabled())
+			{
+				// Folds the per-thread LLM state into the tag totals before reading them
+				FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+				Tracker.UpdateStatsPerFrame();
+				const FName Tag(TEXT("DungeonBenchmark"));
+				Counters.TaggedBytes = Tracker.GetTagAmountForTracker(ELLMTracker::Default, Tag, ELLMTagSet::None, UE::LLM::ESizeParams::ReportCurrent);
+				Counters.TaggedPeakBytes = Tracker.GetTagAmountForTracker(ELLMTracker::Default, Tag, ELLMTagSet::None, UE::LLM::ESizeParams::ReportPeak);
+			}
+#endif
+			return Counters;
+		}
+	};
+
+	template<typename FunctionType>
+	void MeasureStage(const TCHAR* Stage, int32 NbRoom, TArray<FDungeonBenchmarkSample>& OutSamples, FunctionType&& Function)
+	{
+		const FHeapCounters Before = FHeapCounters::Read();
+		const double StartTime = FPlatformTime::Seconds();
+		{
+			LLM_SCOPE_BYTAG(DungeonBenchmark);
+			Function();
+		}
+		const double EndTime = FPlatformTime::Seconds();
+		const FHeapCounters After = FHeapCounters::Read();
+
+		FDungeonBenchmarkSample& Sample = OutSamples.AddDefaulted_GetRef();
+		Sample.Stage = Stage;
+		Sample.NbRoom = NbRoom;
+		Sample.Milliseconds = (EndTime - StartTime) * 1000.0;
+		Sample.NumAllocations = After.NumAllocations >= 0 ? After.NumAllocations - Before.NumAllocations : -1;
+		Sample.RetainedBytes = After.TaggedBytes >= 0 ? After.TaggedBytes - Before.TaggedBytes : -1;
+		Sample.PeakBytes = -1;
+		if (After.TaggedPeakBytes >= 0)
+		{
+			// The LLM peak is never reset, it only tells the stage peak when the stage raised it
+			Sample.PeakBytes = After.TaggedPeakBytes > Before.TaggedPeakBytes ? After.TaggedPeakBytes - Before.TaggedBytes : FMath::Max<int64>(Sample.RetainedBytes, 0);
+		}
+		Sample.UsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+
+		UE_LOG(LogTemp, Display, TEXT("[Benchmark] %s (%d rooms): %.2f ms, %lld allocations, %lld bytes peak"),
+			Stage, NbRoom, Sample.Milliseconds, Sample.NumAllocations, Sample.PeakBytes);
+	}
+
+	void RunBenchmarkCommand(const TArray<FString>& Args, UWorld* World)
+	{
+		FDungeonBenchmarkSettings Settings;
+		if (!FDungeonBenchmark::ParseSettings(*FString::Join(Args, TEXT(" ")), Settings))
+		{
+			return;
+		}
+
+		TArray<FDungeonBenchmarkSample> Samples;
+		FDungeonBenchmark::Run(World, Settings, Samples);
+
+		const FString Path = FDungeonBenchmark::MakeOutputPath();
+		if (FDungeonBenchmark::WriteJson(Path, Settings, Samples))
+		{
+			UE_LOG(LogTemp, Display, TEXT("[Benchmark] %d samples written to %s"), Samples.Num(), *Path);
+		}
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("Dungeon.Benchmark"),
+		TEXT("Times every generation stage and writes Saved/Benchmarks/DungeonBenchmark-<date>.json.\n")
+		TEXT("Arguments: Rooms=100,1000,10000,100000 Seed=1 Core=1 Actors=1 Parallel=1 Config=<data asset> Primary=<class> Secondary=<class> Triangle=<class> Corridor=<class>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RunBenchmarkCommand));
+}
+
+bool FDungeonBenchmark::ParseSettings(const TCHAR* Line, FDungeonBenchmarkSettings& OutSettings)
+{
+	FString RoomCounts;
+	if (FParse::Value(Line, TEXT("Rooms="), RoomCounts, false))
+	{
+		TArray<FString> Counts;
+		RoomCounts.ParseIntoArray(Counts, TEXT(","));
+		OutSettings.RoomCounts.Reset();
+		for (const FString& Count : Counts)
+		{
+			OutSettings.RoomCounts.Add(FCString::Atoi(*Count));
+		}
+	}
+	FParse::Value(Line, TEXT("Seed="), OutSettings.Seed);
+	FParse::Bool(Line, TEXT("Core="), OutSettings.bCoreStages);
+	FParse::Bool(Line, TEXT("Actors="), OutSettings.bActorStages);
+	FParse::Bool(Line, TEXT("Parallel="), OutSettings.bParallelTriangulation);
+
+	// Defaults match the assets of the sample project
+	FString ConfigPath = TEXT("/Game/ConfigRoom.ConfigRoom");
+	FString PrimaryPath = TEXT("/Game/MainRoom.MainRoom_C");
+	FString SecondaryPath = TEXT("/Game/SecondaryRoom.SecondaryRoom_C");
+	FString TrianglePath = TEXT("/Game/TriangulationBlock.TriangulationBlock_C");
+	FString CorridorPath = TEXT("/Game/Corridor.Corridor_C");
+	FParse::Value(Line, TEXT("Config="), ConfigPath);
+	FParse::Value(Line, TEXT("Primary="), PrimaryPath);
+	FParse::Value(Line, TEXT("Secondary="), SecondaryPath);
+	FParse::Value(Line, TEXT("Triangle="), TrianglePath);
+	FParse::Value(Line, TEXT("Corridor="), CorridorPath);
+
+	const UConfigRoomDataAsset* Config = LoadObject<UConfigRoomDataAsset>(nullptr, *ConfigPath);
+	if (!Config)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Benchmark] Cannot load room config %s."), *ConfigPath);
+		return false;
+	}
+	OutSettings.RoomTypes = Config->RoomTypes;
+	OutSettings.PrimaryRoom = LoadClass<ARoomParent>(nullptr, *PrimaryPath);
+	OutSettings.SecondaryRoom = LoadClass<ARoomParent>(nullptr, *SecondaryPath);
+	OutSettings.TriangleRoom = LoadClass<ARoomParent>(nullptr, *TrianglePath);
+	OutSettings.Corridor = LoadClass<AActor>(nullptr, *CorridorPath);
+	if (!OutSettings.TriangleRoom)
+	{
+		OutSettings.TriangleRoom = OutSettings.PrimaryRoom;
+	}
+	return true;
+}
+
+FString FDungeonBenchmark::MakeOutputPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("DungeonBenchmark-%s.json"), *FDateTime::Now().ToString());
+}
+
+void FDungeonBenchmark::Run(UWorld* World, const FDungeonBenchmarkSettings& Settings, TArray<FDungeonBenchmarkSample>& OutSamples)
+{
+	URoomManager* RoomManager = World ? World->GetSubsystem<URoomManager>() : nullptr;
+	if (Settings.bActorStages && (!RoomManager || !Settings.PrimaryRoom || !Settings.SecondaryRoom || !Settings.Corridor))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[Benchmark] Actor stages skipped: they need a world and the primary, secondary and corridor classes."));
+	}
+	const bool bActorStages = Settings.bActorStages && RoomManager && Settings.PrimaryRoom && Settings.SecondaryRoom && Settings.Corridor;
+
+	// The actor stages must generate every time, not replay cached layouts or reuse pooled actors
+	const bool bSavedUseLayoutCache = bActorStages && RoomManager->bUseLayoutCache;
+	const bool bSavedParallelTriangulation = bActorStages && RoomManager->bParallelTriangulation;
+	if (bActorStages)
+	{
+		RoomManager->ClearAll();
+		RoomManager->bUseLayoutCache = false;
+		RoomManager->bParallelTriangulation = Settings.bParallelTriangulation;
+	}
+
+	for (const int32 NbRoom : Settings.RoomCounts)
+	{
+		if (Settings.bCoreStages)
+		{
+			FDungeonGenerationSettings GenerationSettings = URoomManager::MakeGenerationSettings(NbRoom, Settings.RoomTypes, Settings.PrimaryRoom, Settings.SecondaryRoom, Settings.Seed);
+			GenerationSettings.bParallelTriangulation = Settings.bParallelTriangulation;
+			FDungeonGenerator Generator(GenerationSettings);
+			MeasureStage(TEXT("Core.SampleRooms"), NbRoom, OutSamples, [&Generator] { Generator.SampleRooms(); });
+			MeasureStage(TEXT("Core.ResolveRoomOverlaps"), NbRoom, OutSamples, [&Generator] { Generator.ResolveRoomOverlaps(); });
+			MeasureStage(TEXT("Core.Triangulate"), NbRoom, OutSamples, [&Generator] { Generator.Triangulate(); });
+			MeasureStage(TEXT("Core.CreatePath"), NbRoom, OutSamples, [&Generator] { Generator.CreatePath(); });
+			MeasureStage(TEXT("Core.EvolvePath"), NbRoom, OutSamples, [&Generator] { Generator.EvolvePath(); });
+			MeasureStage(TEXT("Core.ClearSecondaryRooms"), NbRoom, OutSamples, [&Generator] { Generator.ClearSecondaryRooms(); });
+
+			// Triangle accessors and comparisons of the actor loops, a non-zero allocation count is a regression
+			TArray<FTriangle> Triangles;
+			Generator.GetLayout().ToTriangles(Triangles);
+			MeasureStage(TEXT("Geometry.TriangleOps"), NbRoom, OutSamples, [&Triangles]
+			{
+				int32 NumMatches = 0;
+				for (int32 Index = 0; Index < Triangles.Num(); ++Index)
+				{
+					const FTriangle Triangle = Triangles[Index];
+					const FTriangle& Next = Triangles[(Index + 1) % Triangles.Num()];
+					NumMatches += Triangle == Next;
+					for (const FTriangleEdge& Edge : Triangle.GetEdges())
+					{
+						for (const FTriangleEdge& NextEdge : Next.GetEdges())
+						{
+							NumMatches += Edge == NextEdge;
+						}
+					}
+					for (const FVector& Point : Next.GetAllPoints())
+					{
+						NumMatches += !Triangle.HasVertex(Point) && Triangle.IsPointInCircumcircle(Point);
+					}
+				}
+				volatile int32 Sink = NumMatches;
+				(void)Sink;
+			});
+			if (OutSamples.Last().NumAllocations > 0)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[Benchmark] Triangle operations allocated %lld times."), OutSamples.Last().NumAllocations);
+			}
+
+			// A whole run makes the same number of allocations at any room count,
+			// and running the same generator again reuses all of its memory
+			MeasureStage(TEXT("Core.Run"), NbRoom, OutSamples, [&GenerationSettings]
+			{
+				FDungeonGenerator RunGenerator(GenerationSettings);
+				RunGenerator.Run();
+			});
+			MeasureStage(TEXT("Core.Rerun"), NbRoom, OutSamples, [&Generator] { Generator.Run(); });
+			OutSamples.Last().ScratchHighWaterBytes = Generator.GetScratchArena().GetHighWaterBytes();
+			UE_LOG(LogTemp, Display, TEXT("[Benchmark] Scratch arena (%d rooms): %lld bytes high-water, %d block allocations"),
+				NbRoom, OutSamples.Last().ScratchHighWaterBytes, Generator.GetScratchArena().GetNumBlockAllocations());
+		}
+
+		if (bActorStages)
+		{
+			RoomManager->EmptyLayoutCache();
+			RoomManager->EmptyActorPool();
+			MeasureStage(TEXT("GenerateMap"), NbRoom, OutSamples, [&] { RoomManager->GenerateMap(NbRoom, Settings.RoomTypes, Settings.Seed); });
+			MeasureStage(TEXT("MegaTriangle"), NbRoom, OutSamples, [&] { RoomManager->MegaTriangle(Settings.TriangleRoom); });
+			MeasureStage(TEXT("Triangulation"), NbRoom, OutSamples, [&] { RoomManager->Triangulation(Settings.PrimaryRoom); });
+			MeasureStage(TEXT("CreatePath"), NbRoom, OutSamples, [&] { RoomManager->CreatePath(Settings.PrimaryRoom); });
+			MeasureStage(TEXT("EvolvePath"), NbRoom, OutSamples, [&] { RoomManager->EvolvePath(); });
+			MeasureStage(TEXT("ClearSecondaryRoom"), NbRoom, OutSamples, [&] { RoomManager->ClearSecondaryRoom(Settings.SecondaryRoom); });
+			MeasureStage(TEXT("SpawnConnectionModules"), NbRoom, OutSamples, [&] { RoomManager->SpawnConnectionModules(Settings.Corridor); });
+			MeasureStage(TEXT("ClearAll"), NbRoom, OutSamples, [&] { RoomManager->ClearAll(); });
+		}
+	}
+
+	if (bActorStages)
+	{
+		RoomManager->EmptyActorPool();
+		RoomManager->bUseLayoutCache = bSavedUseLayoutCache;
+		RoomManager->bParallelTriangulation = bSavedParallelTriangulation;
+	}
+}
+
+bool FDungeonBenchmark::WriteJson(const FString& Path, const FDungeonBenchmarkSettings& Settings, TConstArrayView<FDungeonBenchmarkSample> Samples)
+{
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Date"), FDateTime::UtcNow().ToIso8601());
+	Writer->WriteValue(TEXT("Platform"), FString(FPlatformProperties::IniPlatformName()));
+	Writer->WriteValue(TEXT("Configuration"), FString(LexToString(FApp::GetBuildConfiguration())));
+	Writer->WriteValue(TEXT("Seed"), Settings.Seed);
+	Writer->WriteValue(TEXT("ParallelTriangulation"), Settings.bParallelTriangulation);
+
+	Writer->WriteArrayStart(TEXT("Samples"));
+	for (const FDungeonBenchmarkSample& Sample : Samples)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Stage"), Sample.Stage);
+		Writer->WriteValue(TEXT("NbRoom"), Sample.NbRoom);
+		Writer->WriteValue(TEXT("Milliseconds"), Sample.Milliseconds);
+		Writer->WriteValue(TEXT("NumAllocations"), Sample.NumAllocations);
+		Writer->WriteValue(TEXT("RetainedBytes"), Sample.RetainedBytes);
+		Writer->WriteValue(TEXT("PeakBytes"), Sample.PeakBytes);
+		Writer->WriteValue(TEXT("UsedPhysical"), int64(Sample.UsedPhysical));
+		Writer->WriteValue(TEXT("ScratchHighWaterBytes"), Sample.ScratchHighWaterBytes);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Output, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Benchmark] Cannot write %s."), *Path);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,71 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/ConfigRoomDataAsset.h"
+
+// Inputs of a benchmark run
+struct FDungeonBenchmarkSettings
+{
+	// Every stage is measured once per room count
+	TArray<int32> RoomCounts = {100, 1000, 10000, 100000};
+	int32 Seed = 1;
+
+	// Headless FDungeonGenerator stages, no world needed
+	bool bCoreStages = true;
+
+	// URoomManager stages, spawn actors in the given world
+	bool bActorStages = true;
+
+	// Triangulation path measured by both the core and the actor stages
+	bool bParallelTriangulation = true;
+
+	TArray<FRoomType> RoomTypes;
+	TSubclassOf<ARoomParent> PrimaryRoom;
+	TSubclassOf<ARoomParent> SecondaryRoom;
+	TSubclassOf<ARoomParent> TriangleRoom;
+	TSubclassOf<AActor> Corridor;
+};
+
+// Measure of one stage at one room count
+struct FDungeonBenchmarkSample
+{
+	FString Stage;
+	int32 NbRoom = 0;
+	double Milliseconds = 0;
+
+	// Malloc and Realloc calls during the stage, every thread included, -1 without STATS
+	int64 NumAllocations = -1;
+
+	// Heap the stage kept and the highest heap it reached, relative to its start, from the LLM tag of the
+	// stage. -1 unless running with -llm. The peak is exact when the stage raised the tag high-water mark,
+	// the usual case with growing room counts, otherwise it falls back to the retained bytes.
+	int64 RetainedBytes = -1;
+	int64 PeakBytes = -1;
+
+	// Process memory once the stage is done
+	uint64 UsedPhysical = 0;
+
+	// High-water mark of the generator scratch arena, full pipeline runs only
+	int64 ScratchHighWaterBytes = 0;
+};
+
+// Times each generation stage at fixed seeds and writes the results as JSON
+// Run from the console with Dungeon.Benchmark, see DungeonBenchmark.cpp for the arguments, or from the
+// DungeonProcedural.Benchmark performance automation test.
+class DUNGEONPROCEDURAL_API FDungeonBenchmark
+{
+public:
+	// Reads the Dungeon.Benchmark arguments and loads the assets, false if the room config cannot be loaded
+	static bool ParseSettings(const TCHAR* Line, FDungeonBenchmarkSettings& OutSettings);
+
+	// Saved/Benchmarks/DungeonBenchmark-<date>.json
+	static FString MakeOutputPath();
+
+	// Runs every enabled stage for every room count, World is only needed by the actor stages
+	static void Run(UWorld* World, const FDungeonBenchmarkSettings& Settings, TArray<FDungeonBenchmarkSample>& OutSamples);
+
+	// Writes the samples to Path as a JSON document
+	static bool WriteJson(const FString& Path, const FDungeonBenchmarkSettings& Settings, TConstArrayView<FDungeonBenchmarkSample> Samples);
+};
@@ -0,0 +1,72 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonBenchmark.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	// The actor stages need a running game, in PIE or a standalone game
+	UWorld* FindGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::PIE || Context.WorldType == EWorldType::Game) && Context.World())
+			{
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+}
+
+// One test per default room count, each writes its own Saved/Benchmarks file
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FDungeonBenchmarkTest, "DungeonProcedural.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FDungeonBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 NbRoom : FDungeonBenchmarkSettings().RoomCounts)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%d rooms"), NbRoom));
+		OutTestCommands.Add(FString::Printf(TEXT("Rooms=%d"), NbRoom));
+	}
+}
+
+bool FDungeonBenchmarkTest::RunTest(const FString& Parameters)
+{
+	FDungeonBenchmarkSettings Settings;
+	if (!FDungeonBenchmark::ParseSettings(*Parameters, Settings))
+	{
+		AddError(TEXT("Cannot load the benchmark room config."));
+		return false;
+	}
+
+	UWorld* World = FindGameWorld();
+	if (!World)
+	{
+		AddInfo(TEXT("No game world running, only the headless stages are measured."));
+		Settings.bActorStages = false;
+	}
+
+	TArray<FDungeonBenchmarkSample> Samples;
+	FDungeonBenchmark::Run(World, Settings, Samples);
+	TestTrue(TEXT("Every stage was measured"), Samples.Num() > 0);
+
+	for (const FDungeonBenchmarkSample& Sample : Samples)
+	{
+		AddInfo(FString::Printf(TEXT("%s: %.2f ms, %lld allocations, %lld bytes peak"),
+			*Sample.Stage, Sample.Milliseconds, Sample.NumAllocations, Sample.PeakBytes));
+	}
+
+	const FString Path = FDungeonBenchmark::MakeOutputPath();
+	TestTrue(TEXT("Results written"), FDungeonBenchmark::WriteJson(Path, Settings, Samples));
+	return true;
+}
+
+#endif
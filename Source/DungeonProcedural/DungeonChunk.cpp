@@ -0,0 +1,129 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonChunk.h"
+
+#include "DungeonProcedural/DungeonGenerator.h"
+
+namespace
+{
+	// SplitMix64 finalizer, neighbor chunks and borders give unrelated values
+	uint32 MixChunkHash(int32 Seed, const FIntPoint& Chunk, uint32 Salt)
+	{
+		uint64 Hash = (uint64(uint32(Chunk.X)) << 32 | uint64(uint32(Chunk.Y))) ^ (uint64(uint32(Seed)) * 0x9E3779B97F4A7C15ull + Salt);
+		Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+		Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+		Hash ^= Hash >> 31;
+		return uint32(Hash);
+	}
+}
+
+void FDungeonChunkGenerator::Generate(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, FDungeonLayout& OutLayout)
+{
+	FDungeonGenerationSettings Settings = ChunkSettings.Generation;
+	Settings.NbRoom = ChunkSettings.RoomsPerChunk;
+	Settings.Seed = GetChunkSeed(ChunkSettings.WorldSeed, Chunk);
+
+	FDungeonGenerator Generator(Settings);
+	Generator.RunStage(EDungeonStage::SampleRooms);
+	Generator.RunStage(EDungeonStage::ResolveOverlaps);
+
+	// Center the rooms on the chunk and drop the ones reaching into the border strip
+	FDungeonLayout& Layout = Generator.GetLayout();
+	const FVector2f Min = GetChunkOrigin(Chunk, ChunkSettings.ChunkSize) + FVector2f(ChunkSettings.BorderMargin);
+	const FVector2f Max = GetChunkOrigin(Chunk, ChunkSettings.ChunkSize) + FVector2f(ChunkSettings.ChunkSize - ChunkSettings.BorderMargin);
+	const FVector2f Center = GetChunkOrigin(Chunk, ChunkSettings.ChunkSize) + FVector2f(ChunkSettings.ChunkSize / 2);
+	for (int32 RoomIndex = 0; RoomIndex < Layout.NumRooms(); ++RoomIndex)
+	{
+		FVector2f& RoomCenter = Layout.RoomCenters[RoomIndex];
+		RoomCenter += Center;
+
+		const FVector2f& Extent = Layout.RoomExtents[RoomIndex];
+		if (RoomCenter.X - Extent.X < Min.X || RoomCenter.Y - Extent.Y < Min.Y || RoomCenter.X + Extent.X > Max.X || RoomCenter.Y + Extent.Y > Max.Y)
+		{
+			Layout.RoomKept[RoomIndex] = false;
+		}
+	}
+	Layout.PrimaryRooms.RemoveAll([&Layout](int32 RoomIndex) { return !Layout.RoomKept[RoomIndex]; });
+
+	Generator.RunStage(EDungeonStage::Triangulate);
+	Generator.RunStage(EDungeonStage::CreatePath);
+	Generator.RunStage(EDungeonStage::EvolvePath);
+
+	// Portal corridors go in before the culling, secondary rooms on their way are kept
+	AddPortalCorridors(ChunkSettings, Chunk, Layout);
+	Generator.RunStage(EDungeonStage::ClearSecondaryRooms);
+
+	OutLayout = MoveTemp(Layout);
+}
+
+int32 FDungeonChunkGenerator::GetChunkSeed(int32 WorldSeed, const FIntPoint& Chunk)
+{
+	// Positive like the seeds URoomManager::ResolveSeed picks
+	return int32(MixChunkHash(WorldSeed, Chunk, 0) & MAX_int32);
+}
+
+FIntPoint FDungeonChunkGenerator::GetChunkAt(const FVector2f& Location, float ChunkSize)
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / ChunkSize), FMath::FloorToInt32(Location.Y / ChunkSize));
+}
+
+FVector2f FDungeonChunkGenerator::GetChunkOrigin(const FIntPoint& Chunk, float ChunkSize)
+{
+	return FVector2f(Chunk.X * ChunkSize, Chunk.Y * ChunkSize);
+}
+
+FVector2f FDungeonChunkGenerator::GetPortal(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, EDungeonChunkSide Side)
+{
+	// A border belongs to the chunk on its lower side, both neighbors hash the same owner
+	FIntPoint Owner = Chunk;
+	const bool bAlongY = Side == EDungeonChunkSide::East || Side == EDungeonChunkSide::West;
+	if (Side == EDungeonChunkSide::West)
+	{
+		--Owner.X;
+	}
+	else if (Side == EDungeonChunkSide::South)
+	{
+		--Owner.Y;
+	}
+
+	// Salt 0 is the chunk seed
+	const uint32 Hash = MixChunkHash(ChunkSettings.WorldSeed, Owner, bAlongY ? 1 : 2);
+	const float Alpha = float(Hash >> 8) / float(1 << 24);
+	const float Along = FMath::Lerp(ChunkSettings.BorderMargin, ChunkSettings.ChunkSize - ChunkSettings.BorderMargin, Alpha);
+
+	const FVector2f Origin = GetChunkOrigin(Owner, ChunkSettings.ChunkSize);
+	return bAlongY ? FVector2f(Origin.X + ChunkSettings.ChunkSize, Origin.Y + Along) : FVector2f(Origin.X + Along, Origin.Y + ChunkSettings.ChunkSize);
+}
+
+void FDungeonChunkGenerator::AddPortalCorridors(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, FDungeonLayout& Layout)
+{
+	const FVector2f Center = GetChunkOrigin(Chunk, ChunkSettings.ChunkSize) + FVector2f(ChunkSettings.ChunkSize / 2);
+
+	for (int32 Side = 0; Side < int32(EDungeonChunkSide::Num); ++Side)
+	{
+		const FVector2f Portal = GetPortal(ChunkSettings, Chunk, EDungeonChunkSide(Side));
+
+		// A chunk without primary rooms still links its portals together through its center
+		FVector2f From = Center;
+		float BestDistSq = MAX_flt;
+		for (int32 RoomIndex : Layout.PrimaryRooms)
+		{
+			const float DistSq = FVector2f::DistSquared(Layout.RoomCenters[RoomIndex], Portal);
+			if (DistSq < BestDistSq)
+			{
+				BestDistSq = DistSq;
+				From = Layout.RoomCenters[RoomIndex];
+			}
+		}
+
+		// The last segment is perpendicular to the border, so it never runs along the border strip
+		const bool bEastWest = Side == int32(EDungeonChunkSide::East) || Side == int32(EDungeonChunkSide::West);
+		const FVector2f Corner = bEastWest ? FVector2f(From.X, Portal.Y) : FVector2f(Portal.X, From.Y);
+		if (!Corner.Equals(From))
+		{
+			Layout.CorridorSegments.Add(FDungeonSegment(From, Corner));
+		}
+		Layout.CorridorSegments.Add(FDungeonSegment(Corner, Portal));
+	}
+}
@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonLayout.h"
+
+// Border of a chunk, in counter-clockwise order starting at +X
+enum class EDungeonChunkSide : uint8
+{
+	East,
+	North,
+	West,
+	South,
+	Num
+};
+
+// Input of a chunked dungeon, shared by every chunk of the world
+struct FDungeonChunkSettings
+{
+	// Side of a square chunk in world units
+	float ChunkSize = 20000.f;
+
+	// Rooms sampled per chunk, rooms pushed past the chunk borders are dropped
+	int32 RoomsPerChunk = 40;
+
+	// Each chunk derives its own seed from it and its coordinates
+	int32 WorldSeed = 0;
+
+	// Strip along the borders kept free of rooms, so rooms of two chunks never touch
+	float BorderMargin = 500.f;
+
+	// Room types of every chunk, NbRoom and Seed are set per chunk
+	FDungeonGenerationSettings Generation;
+};
+
+// Generates one cell of an unbounded dungeon, independently of its neighbors
+// Each border has one portal point, hashed from the world seed and the border only, so both chunks
+// sharing it place it at the same spot. Every chunk runs a corridor to each of its four portals,
+// which stitches the corridors of neighbor chunks whatever order they are generated in.
+class DUNGEONPROCEDURAL_API FDungeonChunkGenerator
+{
+public:
+	// Full pipeline for the chunk, rooms and corridors are in world space
+	static void Generate(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, FDungeonLayout& OutLayout);
+
+	static int32 GetChunkSeed(int32 WorldSeed, const FIntPoint& Chunk);
+
+	static FIntPoint GetChunkAt(const FVector2f& Location, float ChunkSize);
+
+	// Corner of the chunk with the smallest coordinates
+	static FVector2f GetChunkOrigin(const FIntPoint& Chunk, float ChunkSize);
+
+	// Point where the corridors of Chunk and of its neighbor on Side meet
+	static FVector2f GetPortal(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, EDungeonChunkSide Side);
+
+private:
+	// L-shaped corridor from the nearest primary room to each portal, crossing the border at a right angle
+	static void AddPortalCorridors(const FDungeonChunkSettings& ChunkSettings, const FIntPoint& Chunk, FDungeonLayout& Layout);
+};
@@ -0,0 +1,286 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonChunkSubsystem.h"
+
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Tasks/Task.h"
+
+void UDungeonChunkSubsystem::StartChunkStreaming(const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS,
+	TSubclassOf<AActor> CorridorBP, int32 WorldSeed, int32 RoomsPerChunk, float ChunkSize)
+{
+	StopChunkStreaming();
+	if (ChunkSize <= 0 || RoomsPerChunk < 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Chunk streaming needs a positive chunk size."));
+		return;
+	}
+
+	ChunkSettings = FDungeonChunkSettings();
+	ChunkSettings.ChunkSize = ChunkSize;
+	ChunkSettings.RoomsPerChunk = RoomsPerChunk;
+	ChunkSettings.WorldSeed = WorldSeed >= 0 ? WorldSeed : FDungeonGenerator::MakeRandomSeed();
+	ChunkSettings.Generation = URoomManager::MakeGenerationSettings(RoomsPerChunk, RoomTypes, RoomP, RoomS, ChunkSettings.WorldSeed);
+
+	// Chunks are small, the serial triangulation is faster than splitting them across workers
+	ChunkSettings.Generation.bParallelTriangulation = false;
+	ChunkRoomTypes = RoomTypes;
+	ChunkCorridorBP = CorridorBP;
+
+	GetWorld()->GetTimerManager().SetTimer(StreamingTimer, this, &UDungeonChunkSubsystem::UpdateFromPlayers, FMath::Max(0.05f, UpdateInterval), true);
+	UpdateFromPlayers();
+
+	UE_LOG(LogTemp, Display, TEXT("Chunk streaming started (seed %d, %d rooms per chunk)."), ChunkSettings.WorldSeed, RoomsPerChunk);
+}
+
+void UDungeonChunkSubsystem::StopChunkStreaming()
+{
+	GetWorld()->GetTimerManager().ClearTimer(StreamingTimer);
+
+	TArray<FIntPoint> Loaded;
+	Chunks.GetKeys(Loaded);
+	for (const FIntPoint& Chunk : Loaded)
+	{
+		EvictChunk(Chunk);
+	}
+}
+
+void UDungeonChunkSubsystem::Deinitialize()
+{
+	// The world is going away, only drop the pending jobs
+	for (TPair<FIntPoint, FDungeonChunk>& Pair : Chunks)
+	{
+		if (Pair.Value.Job)
+		{
+			Pair.Value.Job->bCancelled = true;
+		}
+	}
+	Chunks.Empty();
+
+	Super::Deinitialize();
+}
+
+void UDungeonChunkSubsystem::UpdateFromPlayers()
+{
+	TArray<FVector> Locations;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			Locations.Add(PlayerController->GetPawn()->GetActorLocation());
+		}
+	}
+	UpdateChunks(Locations);
+}
+
+void UDungeonChunkSubsystem::UpdateChunks(const TArray<FVector>& Locations)
+{
+	// No streaming source (pawn respawning), keep the current chunks
+	if (ChunkSettings.ChunkSize <= 0 || Locations.Num() == 0)
+	{
+		return;
+	}
+
+	TArray<FIntPoint> Centers;
+	for (const FVector& Location : Locations)
+	{
+		Centers.AddUnique(GetChunkAt(Location));
+	}
+
+	// Distance in chunks to the nearest location
+	auto GetDistance = [&Centers](const FIntPoint& Chunk)
+	{
+		int32 Distance = MAX_int32;
+		for (const FIntPoint& Center : Centers)
+		{
+			Distance = FMath::Min(Distance, FMath::Max(FMath::Abs(Chunk.X - Center.X), FMath::Abs(Chunk.Y - Center.Y)));
+		}
+		return Distance;
+	};
+
+	const int32 Load = FMath::Max(LoadRadius, 0);
+	const int32 Unload = FMath::Max(UnloadRadius, Load);
+
+	TArray<FIntPoint> Loaded;
+	Chunks.GetKeys(Loaded);
+	for (const FIntPoint& Chunk : Loaded)
+	{
+		if (GetDistance(Chunk) > Unload)
+		{
+			EvictChunk(Chunk);
+		}
+	}
+
+	// Missing chunks, nearest first so the cap never skips the one a player stands in
+	TArray<FIntPoint> Missing;
+	for (const FIntPoint& Center : Centers)
+	{
+		for (int32 Y = -Load; Y <= Load; ++Y)
+		{
+			for (int32 X = -Load; X <= Load; ++X)
+			{
+				const FIntPoint Chunk = Center + FIntPoint(X, Y);
+				if (!Chunks.Contains(Chunk))
+				{
+					Missing.AddUnique(Chunk);
+				}
+			}
+		}
+	}
+	Missing.StableSort([&GetDistance](const FIntPoint& A, const FIntPoint& B) { return GetDistance(A) < GetDistance(B); });
+
+	for (const FIntPoint& Chunk : Missing)
+	{
+		if (Chunks.Num() >= MaxLoadedChunks)
+		{
+			// Make room with the farthest chunk outside the load radius, if any
+			FIntPoint Farthest = FIntPoint::ZeroValue;
+			int32 FarthestDistance = Load;
+			for (const TPair<FIntPoint, FDungeonChunk>& Pair : Chunks)
+			{
+				const int32 Distance = GetDistance(Pair.Key);
+				if (Distance > FarthestDistance)
+				{
+					FarthestDistance = Distance;
+					Farthest = Pair.Key;
+				}
+			}
+			if (FarthestDistance == Load)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("MaxLoadedChunks (%d) is too low for the load radius of every location."), MaxLoadedChunks);
+				break;
+			}
+			EvictChunk(Farthest);
+		}
+		LoadChunk(Chunk);
+	}
+}
+
+FIntPoint UDungeonChunkSubsystem::GetChunkAt(const FVector& Location) const
+{
+	return FDungeonChunkGenerator::GetChunkAt(FVector2f(Location.X, Location.Y), ChunkSettings.ChunkSize);
+}
+
+bool UDungeonChunkSubsystem::IsChunkLoaded(FIntPoint Chunk) const
+{
+	return GetChunkLayout(Chunk) != nullptr;
+}
+
+const FDungeonLayout* UDungeonChunkSubsystem::GetChunkLayout(const FIntPoint& Chunk) const
+{
+	const FDungeonChunk* Found = Chunks.Find(Chunk);
+	return Found && !Found->Job ? &Found->Layout : nullptr;
+}
+
+void UDungeonChunkSubsystem::LoadChunk(const FIntPoint& Chunk)
+{
+	const TSharedRef<FDungeonAsyncJob> Job = MakeShared<FDungeonAsyncJob>();
+	Chunks.Add(Chunk).Job = Job;
+
+	TWeakObjectPtr<UDungeonChunkSubsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Job, Chunk, Settings = ChunkSettings]()
+	{
+		if (Job->bCancelled)
+		{
+			return;
+		}
+
+		FDungeonLayout Layout;
+		FDungeonChunkGenerator::Generate(Settings, Chunk, Layout);
+
+		// Spawn on the game thread, unless the chunk was evicted meanwhile
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, Chunk, Layout = MoveTemp(Layout)]() mutable
+		{
+			UDungeonChunkSubsystem* Subsystem = WeakThis.Get();
+			const FDungeonChunk* Found = Subsystem ? Subsystem->Chunks.Find(Chunk) : nullptr;
+			if (Found && Found->Job == Job)
+			{
+				Subsystem->SpawnChunk(Chunk, MoveTemp(Layout));
+			}
+		});
+	});
+}
+
+void UDungeonChunkSubsystem::SpawnChunk(const FIntPoint& Chunk, FDungeonLayout&& Layout)
+{
+	FDungeonChunk& State = Chunks.FindChecked(Chunk);
+	State.Job.Reset();
+	State.Layout = MoveTemp(Layout);
+
+	const FDungeonLayout& ChunkLayout = State.Layout;
+	for (int32 RoomIndex = 0; RoomIndex < ChunkLayout.NumRooms(); ++RoomIndex)
+	{
+		if (!ChunkLayout.RoomKept[RoomIndex])
+		{
+			continue;
+		}
+
+		const FVector2f& Scale = ChunkLayout.RoomScales[RoomIndex];
+		ARoomParent* Room = ActorPool.Acquire(GetWorld(), ChunkRoomTypes[ChunkLayout.RoomTypeIds[RoomIndex]].TypeOfRoomToSpawn, ChunkLayout.GetRoomLocation(RoomIndex), FRotator::ZeroRotator);
+		if (Room)
+		{
+			Room->SetActorScale3D(FVector(Scale.X, Scale.Y, 1));
+			State.Actors.Add(Room);
+		}
+	}
+
+	// Same merging and placement as URoomManager::SpawnConnectionModules
+	if (ChunkCorridorBP)
+	{
+		CorridorRuns.Build(ChunkLayout.CorridorSegments);
+	}
+	for (int32 SegmentIndex = 0; ChunkCorridorBP && SegmentIndex < CorridorRuns.GetRuns().Num(); ++SegmentIndex)
+	{
+		const FDungeonSegment& Segment = CorridorRuns.GetRuns()[SegmentIndex];
+		FVector Direction(Segment.B.X - Segment.A.X, Segment.B.Y - Segment.A.Y, 0);
+		const float Length = Direction.Length();
+		if (Length <= KINDA_SMALL_NUMBER) continue;
+		Direction /= Length;
+
+		const FVector Middle = FVector(Segment.A.X, Segment.A.Y, 0) + Direction * (Length / 2);
+		AActor* Corridor = ActorPool.Acquire(GetWorld(), ChunkCorridorBP, Middle, Direction.Rotation());
+		if (!Corridor) continue;
+
+		FVector Scale = Corridor->GetActorScale3D();
+		Scale.X = Length / 100.0f;
+		Corridor->SetActorScale3D(Scale);
+		State.Actors.Add(Corridor);
+	}
+
+	OnChunkLoaded.Broadcast(Chunk);
+}
+
+void UDungeonChunkSubsystem::EvictChunk(const FIntPoint& Chunk)
+{
+	FDungeonChunk* Found = Chunks.Find(Chunk);
+	if (!Found)
+	{
+		return;
+	}
+
+	if (Found->Job)
+	{
+		// Still generating, the worker result is dropped
+		Found->Job->bCancelled = true;
+	}
+	else
+	{
+		OnChunkUnloaded.Broadcast(Chunk);
+	}
+
+	// The broadcast may have changed the map
+	Found = Chunks.Find(Chunk);
+	if (!Found)
+	{
+		return;
+	}
+	for (AActor* Actor : Found->Actors)
+	{
+		ActorPool.Release(Actor);
+	}
+	Chunks.Remove(Chunk);
+}
@@ -0,0 +1,126 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/ConfigRoomDataAsset.h"
+#include "DungeonProcedural/DungeonActorPool.h"
+#include "DungeonProcedural/DungeonChunk.h"
+#include "DungeonProcedural/DungeonCorridorRuns.h"
+#include "DungeonProcedural/RoomManager.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DungeonChunkSubsystem.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnDungeonChunkChanged, FIntPoint, Chunk);
+
+// One streamed chunk, its layout is generated on a worker thread
+USTRUCT()
+struct FDungeonChunk
+{
+	GENERATED_BODY()
+
+	// Rooms and corridors spawned for the chunk, released to the pool on eviction
+	UPROPERTY()
+	TArray<AActor*> Actors;
+
+	FDungeonLayout Layout;
+
+	// Set until the layout is spawned
+	TSharedPtr<FDungeonAsyncJob> Job;
+};
+
+/**
+ * World Subsystem streaming an unbounded dungeon around the players.
+ * The world is split into square chunks, each generated from the world seed and its coordinates only.
+ * Chunks near a player are generated in the background, far ones are evicted, so memory is bounded
+ * by MaxLoadedChunks whatever the distance travelled.
+ */
+UCLASS()
+class DUNGEONPROCEDURAL_API UDungeonChunkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+public:
+	// Starts streaming chunks around the player pawns, every UpdateInterval seconds
+	// The same WorldSeed always gives the same dungeon, a negative one picks a random seed.
+	UFUNCTION(BlueprintCallable)
+	void StartChunkStreaming(const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP,
+		int32 WorldSeed = -1, int32 RoomsPerChunk = 40, float ChunkSize = 20000.f);
+
+	// Stops the streaming and evicts every chunk
+	UFUNCTION(BlueprintCallable)
+	void StopChunkStreaming();
+
+	// Loads the chunks around these locations and evicts the far ones, called by the streaming timer
+	// with the player pawn locations, can also be called directly with other streaming sources.
+	UFUNCTION(BlueprintCallable)
+	void UpdateChunks(const TArray<FVector>& Locations);
+
+	UFUNCTION(BlueprintPure)
+	FIntPoint GetChunkAt(const FVector& Location) const;
+
+	// True once the chunk is spawned
+	UFUNCTION(BlueprintPure)
+	bool IsChunkLoaded(FIntPoint Chunk) const;
+
+	UFUNCTION(BlueprintPure)
+	int32 GetNumLoadedChunks() const { return Chunks.Num(); }
+
+	UFUNCTION(BlueprintPure)
+	int32 GetWorldSeed() const { return ChunkSettings.WorldSeed; }
+
+	// Layout of a spawned chunk, nullptr if it is not loaded yet
+	const FDungeonLayout* GetChunkLayout(const FIntPoint& Chunk) const;
+
+	// Chunks up to this many cells away from a location are loaded
+	UPROPERTY(BlueprintReadWrite)
+	int32 LoadRadius = 1;
+
+	// Chunks further than this from every location are evicted, kept above LoadRadius to avoid reloading on borders
+	UPROPERTY(BlueprintReadWrite)
+	int32 UnloadRadius = 2;
+
+	// Hard cap on loaded chunks, the farthest unneeded ones are evicted first
+	UPROPERTY(BlueprintReadWrite)
+	int32 MaxLoadedChunks = 25;
+
+	UPROPERTY(BlueprintReadWrite)
+	float UpdateInterval = 0.5f;
+
+	// Rooms and corridors of the chunk are spawned
+	UPROPERTY(BlueprintAssignable)
+	FOnDungeonChunkChanged OnChunkLoaded;
+
+	// Fired before the actors of the chunk go back to the pool
+	UPROPERTY(BlueprintAssignable)
+	FOnDungeonChunkChanged OnChunkUnloaded;
+
+	virtual void Deinitialize() override;
+
+private:
+	void UpdateFromPlayers();
+
+	void LoadChunk(const FIntPoint& Chunk);
+	void EvictChunk(const FIntPoint& Chunk);
+
+	// Game thread side of LoadChunk, once the worker is done
+	void SpawnChunk(const FIntPoint& Chunk, FDungeonLayout&& Layout);
+
+	FDungeonChunkSettings ChunkSettings;
+
+	UPROPERTY()
+	TMap<FIntPoint, FDungeonChunk> Chunks;
+
+	UPROPERTY()
+	TArray<FRoomType> ChunkRoomTypes;
+
+	UPROPERTY()
+	TSubclassOf<AActor> ChunkCorridorBP;
+
+	UPROPERTY()
+	FDungeonActorPool ActorPool;
+
+	// Corridors of the chunk being spawned, merged like the ones of URoomManager
+	FDungeonCorridorRuns CorridorRuns;
+
+	FTimerHandle StreamingTimer;
+};
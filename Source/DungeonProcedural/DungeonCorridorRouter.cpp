@@ -0,0 +1,266 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonCorridorRouter.h"
+
+namespace
+{
+	using ELayer = FDungeonOccupancyGrid::ELayer;
+
+	// Moves along +X, -X, +Y, -Y, a move and its reverse only differ by the lowest bit
+	const FIntPoint MoveDeltas[4] = {FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1)};
+
+	// Parent of the start state, and flag of the states already expanded
+	constexpr uint8 StartMove = 4;
+	constexpr uint8 ClosedFlag = 0x80;
+
+	// Step costs, in cells
+	constexpr float FreeCellCost = 1.f;
+	constexpr float CorridorCellCost = 0.5f;
+	constexpr float TurnCost = 2.f;
+
+	// Search window around the two rooms, in cells
+	constexpr int32 MinWindowMargin = 4;
+	constexpr int32 MaxWindowCells = 1 << 16;
+
+	bool IsHorizontal(uint8 Move)
+	{
+		return Move < 2;
+	}
+
+	bool IsInRange(const FIntPoint& Cell, const FIntPoint& Min, const FIntPoint& Max)
+	{
+		return Cell.X >= Min.X && Cell.Y >= Min.Y && Cell.X <= Max.X && Cell.Y <= Max.Y;
+	}
+}
+
+void FDungeonCorridorRouter::Init(const FDungeonLayout& Layout, float CellSize, int32 MaxExpansions)
+{
+	if (CellSize <= 0)
+	{
+		// Half the average primary room half size, so rooms block a few cells and the gaps between them stay open
+		double Sum = 0;
+		for (int32 RoomIndex : Layout.PrimaryRooms)
+		{
+			Sum += FMath::Min(Layout.RoomExtents[RoomIndex].X, Layout.RoomExtents[RoomIndex].Y);
+		}
+		CellSize = Layout.PrimaryRooms.Num() > 0 ? FMath::Max(float(0.5 * Sum / Layout.PrimaryRooms.Num()), 1.f) : 100.f;
+	}
+
+	Grid.InitFromLayout(Layout, CellSize);
+	for (int32 RoomIndex : Layout.PrimaryRooms)
+	{
+		// Only the cells well inside the room, a conservative box would also close the gaps
+		const FVector2f InnerExtent = Layout.RoomExtents[RoomIndex] - 0.5f * Grid.GetCellSize();
+		if (InnerExtent.X >= 0 && InnerExtent.Y >= 0)
+		{
+			Grid.AddBox(ELayer::Room, Layout.RoomCenters[RoomIndex], InnerExtent);
+		}
+	}
+
+	RemainingExpansions = MaxExpansions > 0 ? MaxExpansions : DefaultExpansionsPerEdge * FMath::Max(Layout.PathEdges.Num(), 1);
+}
+
+bool FDungeonCorridorRouter::Route(const FDungeonLayout& Layout, int32 RoomA, int32 RoomB, TArray<FDungeonSegment>& OutSegments, FDungeonArena& Scratch)
+{
+	if (Grid.IsEmpty() || RemainingExpansions <= 0)
+	{
+		return false;
+	}
+
+	const FVector2f& PointA = Layout.RoomCenters[RoomA];
+	const FVector2f& PointB = Layout.RoomCenters[RoomB];
+	const FIntPoint StartCell = Grid.GetCell(PointA);
+	const FIntPoint GoalCell = Grid.GetCell(PointB);
+	if (StartCell == GoalCell)
+	{
+		return false;
+	}
+
+	// The two rooms being joined are open even where the room layer blocks them
+	const FIntPoint RoomAMin = Grid.GetCell(PointA - Layout.RoomExtents[RoomA]);
+	const FIntPoint RoomAMax = Grid.GetCell(PointA + Layout.RoomExtents[RoomA]);
+	const FIntPoint RoomBMin = Grid.GetCell(PointB - Layout.RoomExtents[RoomB]);
+	const FIntPoint RoomBMax = Grid.GetCell(PointB + Layout.RoomExtents[RoomB]);
+
+	const int32 Margin = FMath::Max3(MinWindowMargin, FMath::Abs(GoalCell.X - StartCell.X) / 2, FMath::Abs(GoalCell.Y - StartCell.Y) / 2);
+	const FIntPoint WindowMin = (StartCell.ComponentMin(GoalCell) - FIntPoint(Margin, Margin)).ComponentMax(FIntPoint(0, 0));
+	const FIntPoint WindowMax = (StartCell.ComponentMax(GoalCell) + FIntPoint(Margin, Margin)).ComponentMin(Grid.GetSize() - FIntPoint(1, 1));
+	const int32 Width = WindowMax.X - WindowMin.X + 1;
+	const int32 Height = WindowMax.Y - WindowMin.Y + 1;
+	if (int64(Width) * Height > MaxWindowCells)
+	{
+		return false;
+	}
+
+	// One state per cell and per move that entered it, so turns can be charged
+	const FDungeonArena::FMark Mark(Scratch);
+	const int32 NumStates = Width * Height * 4;
+	TArrayView<float> Costs = Scratch.AllocateArray<float>(NumStates);
+	TArrayView<uint8> Parents = Scratch.AllocateArray<uint8>(NumStates);
+	for (float& Cost : Costs)
+	{
+		Cost = UE_MAX_FLT;
+	}
+	FMemory::Memzero(Parents.GetData(), NumStates);
+
+	auto GetState = [&WindowMin, Width](const FIntPoint& Cell, uint8 Move)
+	{
+		return ((Cell.Y - WindowMin.Y) * Width + Cell.X - WindowMin.X) * 4 + Move;
+	};
+	auto GetStateCell = [&WindowMin, Width](int32 State)
+	{
+		return FIntPoint(WindowMin.X + State / 4 % Width, WindowMin.Y + State / 4 / Width);
+	};
+	// Ignores the cheaper corridor cells, paths are short rather than always the shortest
+	auto Heuristic = [&GoalCell](const FIntPoint& Cell)
+	{
+		return FreeCellCost * float(FMath::Abs(GoalCell.X - Cell.X) + FMath::Abs(GoalCell.Y - Cell.Y));
+	};
+	auto ByEstimate = [](const FOpenState& StateA, const FOpenState& StateB) { return StateA.Estimate < StateB.Estimate; };
+
+	Open.Reset();
+	const int32 StartState = GetState(StartCell, 0);
+	Costs[StartState] = 0;
+	Parents[StartState] = StartMove;
+	Open.HeapPush(FOpenState{Heuristic(StartCell), StartState}, ByEstimate);
+
+	int32 GoalState = INDEX_NONE;
+	while (Open.Num() > 0 && RemainingExpansions > 0)
+	{
+		FOpenState Current;
+		Open.HeapPop(Current, ByEstimate, EAllowShrinking::No);
+		if (Parents[Current.State] & ClosedFlag)
+		{
+			continue;
+		}
+		Parents[Current.State] |= ClosedFlag;
+		--RemainingExpansions;
+
+		const FIntPoint Cell = GetStateCell(Current.State);
+		if (Cell == GoalCell)
+		{
+			GoalState = Current.State;
+			break;
+		}
+
+		const uint8 Move = uint8(Current.State % 4);
+		// Only the start itself, its children also store StartMove as their parent
+		const bool bAtStart = Current.State == StartState;
+		for (uint8 NextMove = 0; NextMove < 4; ++NextMove)
+		{
+			if (!bAtStart && NextMove == (Move ^ 1))
+			{
+				continue;
+			}
+
+			const FIntPoint Next = Cell + MoveDeltas[NextMove];
+			if (!IsInRange(Next, WindowMin, WindowMax)
+				|| (Grid.IsSet(ELayer::Room, Next) && !IsInRange(Next, RoomAMin, RoomAMax) && !IsInRange(Next, RoomBMin, RoomBMax)))
+			{
+				continue;
+			}
+
+			float Cost = Costs[Current.State] + (Grid.IsSet(ELayer::Corridor, Next) ? CorridorCellCost : FreeCellCost);
+			if (!bAtStart && NextMove != Move)
+			{
+				Cost += TurnCost;
+			}
+
+			const int32 NextState = GetState(Next, NextMove);
+			if ((Parents[NextState] & ClosedFlag) == 0 && Cost < Costs[NextState])
+			{
+				Costs[NextState] = Cost;
+				Parents[NextState] = bAtStart ? StartMove : Move;
+				Open.HeapPush(FOpenState{Cost + Heuristic(Next), NextState}, ByEstimate);
+			}
+		}
+	}
+
+	if (GoalState == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Walk back to the start, each state knows the move that entered its cell and the one before
+	PathMoves.Reset();
+	for (int32 State = GoalState;;)
+	{
+		const uint8 Move = uint8(State % 4);
+		const uint8 Parent = Parents[State] & ~ClosedFlag;
+		PathMoves.Add(Move);
+		if (Parent == StartMove)
+		{
+			break;
+		}
+		State = GetState(GetStateCell(State) - MoveDeltas[Move], Parent);
+	}
+
+	const int32 FirstSegment = OutSegments.Num();
+	AddPathSegments(PathMoves, StartCell, PointA, PointB, OutSegments);
+	for (int32 SegmentIndex = FirstSegment; SegmentIndex < OutSegments.Num(); ++SegmentIndex)
+	{
+		AddCorridor(OutSegments[SegmentIndex]);
+	}
+	return true;
+}
+
+void FDungeonCorridorRouter::AddCorridor(const FDungeonSegment& Segment)
+{
+	Grid.AddSegment(ELayer::Corridor, Segment.A, Segment.B);
+}
+
+void FDungeonCorridorRouter::AddPathSegments(TConstArrayView<uint8> Moves, const FIntPoint& StartCell, const FVector2f& PointA, const FVector2f& PointB, TArray<FDungeonSegment>& OutSegments) const
+{
+	// One run per straight stretch, Fixed is its Y if horizontal and its X if vertical
+	struct FRun
+	{
+		bool bHorizontal;
+		float Fixed;
+	};
+	TArray<FRun, TInlineAllocator<16>> Runs;
+
+	// Moves are stored from the goal back to the start
+	FIntPoint Cell = StartCell;
+	for (int32 MoveIndex = Moves.Num() - 1; MoveIndex >= 0; --MoveIndex)
+	{
+		const uint8 Move = Moves[MoveIndex];
+		if (Runs.Num() == 0 || Runs.Last().bHorizontal != IsHorizontal(Move))
+		{
+			// A new run goes through the center of the cell it turns in
+			const FVector2f Center = Grid.GetCellCenter(Cell);
+			Runs.Add(FRun{IsHorizontal(Move), IsHorizontal(Move) ? Center.Y : Center.X});
+		}
+		Cell += MoveDeltas[Move];
+	}
+
+	// The first and the last runs go through the room centers, a straight path ends with a short jog
+	Runs[0].Fixed = Runs[0].bHorizontal ? PointA.Y : PointA.X;
+	if (Runs.Num() == 1)
+	{
+		Runs.Add(FRun{!Runs[0].bHorizontal, Runs[0].bHorizontal ? PointB.X : PointB.Y});
+	}
+	else
+	{
+		Runs.Last().Fixed = Runs.Last().bHorizontal ? PointB.Y : PointB.X;
+	}
+
+	auto AddSegment = [&OutSegments](const FVector2f& From, const FVector2f& To)
+	{
+		if (!From.Equals(To))
+		{
+			OutSegments.Add(FDungeonSegment(From, To));
+		}
+	};
+
+	FVector2f Previous = PointA;
+	for (int32 RunIndex = 0; RunIndex + 1 < Runs.Num(); ++RunIndex)
+	{
+		const FRun& Run = Runs[RunIndex];
+		const FRun& NextRun = Runs[RunIndex + 1];
+		const FVector2f Corner = Run.bHorizontal ? FVector2f(NextRun.Fixed, Run.Fixed) : FVector2f(Run.Fixed, NextRun.Fixed);
+		AddSegment(Previous, Corner);
+		Previous = Corner;
+	}
+	AddSegment(Previous, PointB);
+}
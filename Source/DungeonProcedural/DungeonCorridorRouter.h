@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonArena.h"
+#include "DungeonProcedural/DungeonLayout.h"
+#include "DungeonProcedural/DungeonOccupancyGrid.h"
+
+// Routes corridors on a grid around the primary rooms, an alternative to random L-shapes
+// A* over (cell, direction) states, 4-connected so corridors stay axis aligned. Primary room cells
+// are blocked except those of the two rooms being joined, cells of the corridors routed before are
+// cheaper so corridors merge, and every turn costs extra so they stay straight.
+// Each search is limited to a window around its two rooms and a whole dungeon shares one budget of
+// expanded states, counted rather than timed so a seed routes the same on every machine.
+class DUNGEONPROCEDURAL_API FDungeonCorridorRouter
+{
+public:
+	// Budget per MST edge when the settings give none
+	static constexpr int32 DefaultExpansionsPerEdge = 2048;
+
+	// Blocks the primary rooms of the layout and forgets the corridors of the previous one
+	// A CellSize of 0 picks one from the primary room sizes, a MaxExpansions of 0 the default budget.
+	void Init(const FDungeonLayout& Layout, float CellSize, int32 MaxExpansions);
+
+	// Appends the segments of a corridor from the center of room A to the center of room B
+	// Returns false, with nothing appended, if no route fits the window or the budget ran out.
+	bool Route(const FDungeonLayout& Layout, int32 RoomA, int32 RoomB, TArray<FDungeonSegment>& OutSegments, FDungeonArena& Scratch);
+
+	// Marks a corridor built without the router, later routes can reuse it too
+	void AddCorridor(const FDungeonSegment& Segment);
+
+	int32 GetRemainingExpansions() const { return RemainingExpansions; }
+
+	// Room layer: blocked cells, corridor layer: corridors routed so far
+	const FDungeonOccupancyGrid& GetGrid() const { return Grid; }
+
+private:
+	struct FOpenState
+	{
+		float Estimate;
+		int32 State;
+	};
+
+	// Turns the cells of a found path into axis-aligned segments from PointA to PointB
+	void AddPathSegments(TConstArrayView<uint8> Moves, const FIntPoint& StartCell, const FVector2f& PointA, const FVector2f& PointB, TArray<FDungeonSegment>& OutSegments) const;
+
+	FDungeonOccupancyGrid Grid;
+	TArray<FOpenState> Open;
+
+	// Directions of the moves of the last path, from the goal back to the start
+	TArray<uint8> PathMoves;
+
+	int32 RemainingExpansions = 0;
+};
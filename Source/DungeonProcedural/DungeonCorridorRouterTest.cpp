@@ -0,0 +1,59 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonCorridorRouter.h"
+
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDungeonCorridorRouterTest, "DungeonProcedural.CorridorRouter.RoutesAroundPrimaryRoom",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FDungeonCorridorRouterTest::RunTest(const FString& Parameters)
+{
+	// Rooms 0 and 1 are joined across primary room 2, the secondary rooms 3 and 4 only widen the grid
+	FDungeonLayout Layout;
+	auto AddRoom = [&Layout](const FVector2f& Center, const FVector2f& Extent, bool bPrimary)
+	{
+		if (bPrimary)
+		{
+			Layout.PrimaryRooms.Add(Layout.NumRooms());
+		}
+		Layout.RoomCenters.Add(Center);
+		Layout.RoomExtents.Add(Extent);
+		Layout.RoomScales.Add(FVector2f(1, 1));
+		Layout.RoomTypeIds.Add(0);
+		Layout.RoomKept.Add(true);
+	};
+	AddRoom(FVector2f(0, 0), FVector2f(100, 100), true);
+	AddRoom(FVector2f(2000, 0), FVector2f(100, 100), true);
+	AddRoom(FVector2f(1000, 0), FVector2f(300, 300), true);
+	AddRoom(FVector2f(1000, 1000), FVector2f(100, 100), false);
+	AddRoom(FVector2f(1000, -1000), FVector2f(100, 100), false);
+	Layout.PathEdges.Add(FIntPoint(0, 1));
+
+	FDungeonCorridorRouter Router;
+	FDungeonArena Scratch;
+	Router.Init(Layout, 50.f, 100000);
+
+	TArray<FDungeonSegment> Segments;
+	if (!TestTrue(TEXT("A route is found"), Router.Route(Layout, 0, 1, Segments, Scratch)))
+	{
+		return false;
+	}
+
+	// A straight run or a single L-shape would cross the blocking room
+	TestTrue(TEXT("The route turns around the blocking room"), Segments.Num() > 2);
+	for (const FDungeonSegment& Segment : Segments)
+	{
+		TestFalse(FString::Printf(TEXT("Segment (%s) - (%s) avoids the blocking room"), *Segment.A.ToString(), *Segment.B.ToString()),
+			FDungeonGenerator::IsSegmentIntersectingBox(Segment.A, Segment.B, Layout.RoomCenters[2], Layout.RoomExtents[2]));
+	}
+	TestTrue(TEXT("The route starts at room 0"), Segments[0].A.Equals(Layout.RoomCenters[0]));
+	TestTrue(TEXT("The route ends at room 1"), Segments.Last().B.Equals(Layout.RoomCenters[1]));
+	return true;
+}
+
+#endif
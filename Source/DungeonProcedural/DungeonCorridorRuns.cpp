@@ -0,0 +1,146 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonCorridorRuns.h"
+
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
+#include "DungeonProcedural/DungeonStats.h"
+
+void FDungeonCorridorRuns::Build(TConstArrayView<FDungeonSegment> Segments, float Tolerance)
+{
+	HorizontalRuns.Reset();
+	VerticalRuns.Reset();
+	OtherSegments.Reset();
+	Runs.Reset(Segments.Num());
+	Junctions.Reset();
+
+	for (const FDungeonSegment& Segment : Segments)
+	{
+		const float DeltaX = FMath::Abs(Segment.B.X - Segment.A.X);
+		const float DeltaY = FMath::Abs(Segment.B.Y - Segment.A.Y);
+		if (DeltaX <= Tolerance && DeltaY <= Tolerance)
+		{
+			// Nothing to spawn
+			continue;
+		}
+
+		if (DeltaY <= Tolerance)
+		{
+			HorizontalRuns.Add(FAxisRun{Segment.A.Y, FMath::Min(Segment.A.X, Segment.B.X), FMath::Max(Segment.A.X, Segment.B.X)});
+		}
+		else if (DeltaX <= Tolerance)
+		{
+			VerticalRuns.Add(FAxisRun{Segment.A.X, FMath::Min(Segment.A.Y, Segment.B.Y), FMath::Max(Segment.A.Y, Segment.B.Y)});
+		}
+		else
+		{
+			// Endpoints in a fixed order, so a segment and its reverse sort next to each other
+			const bool bSwap = Segment.B.X < Segment.A.X || (Segment.B.X == Segment.A.X && Segment.B.Y < Segment.A.Y);
+			OtherSegments.Add(bSwap ? FDungeonSegment(Segment.B, Segment.A) : Segment);
+		}
+	}
+
+	MergeAxisRuns(HorizontalRuns, Tolerance);
+	MergeAxisRuns(VerticalRuns, Tolerance);
+	AddJunctions(Tolerance);
+
+	for (const FAxisRun& Run : HorizontalRuns)
+	{
+		Runs.Add(FDungeonSegment(FVector2f(Run.Min, Run.Fixed), FVector2f(Run.Max, Run.Fixed)));
+	}
+	for (const FAxisRun& Run : VerticalRuns)
+	{
+		Runs.Add(FDungeonSegment(FVector2f(Run.Fixed, Run.Min), FVector2f(Run.Fixed, Run.Max)));
+	}
+
+	Algo::Sort(OtherSegments, [](const FDungeonSegment& SegmentA, const FDungeonSegment& SegmentB)
+	{
+		if (SegmentA.A.X != SegmentB.A.X) return SegmentA.A.X < SegmentB.A.X;
+		if (SegmentA.A.Y != SegmentB.A.Y) return SegmentA.A.Y < SegmentB.A.Y;
+		if (SegmentA.B.X != SegmentB.B.X) return SegmentA.B.X < SegmentB.B.X;
+		return SegmentA.B.Y < SegmentB.B.Y;
+	});
+	for (int32 SegmentIndex = 0; SegmentIndex < OtherSegments.Num(); ++SegmentIndex)
+	{
+		const FDungeonSegment& Segment = OtherSegments[SegmentIndex];
+		if (SegmentIndex == 0 || !Segment.A.Equals(Runs.Last().A, Tolerance) || !Segment.B.Equals(Runs.Last().B, Tolerance))
+		{
+			Runs.Add(Segment);
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_DungeonCorridorSegmentsMerged, Segments.Num() - Runs.Num());
+}
+
+void FDungeonCorridorRuns::Reset()
+{
+	HorizontalRuns.Reset();
+	VerticalRuns.Reset();
+	OtherSegments.Reset();
+	Runs.Reset();
+	Junctions.Reset();
+}
+
+void FDungeonCorridorRuns::MergeAxisRuns(TArray<FAxisRun>& InOutRuns, float Tolerance)
+{
+	Algo::Sort(InOutRuns, [](const FAxisRun& RunA, const FAxisRun& RunB) { return RunA.Fixed < RunB.Fixed; });
+
+	int32 NumMerged = 0;
+	for (int32 LineStart = 0; LineStart < InOutRuns.Num();)
+	{
+		// Runs within the tolerance of the first one share its line
+		const float Fixed = InOutRuns[LineStart].Fixed;
+		int32 LineEnd = LineStart + 1;
+		while (LineEnd < InOutRuns.Num() && InOutRuns[LineEnd].Fixed - Fixed <= Tolerance)
+		{
+			++LineEnd;
+		}
+
+		TArrayView<FAxisRun> Line(InOutRuns.GetData() + LineStart, LineEnd - LineStart);
+		Algo::Sort(Line, [](const FAxisRun& RunA, const FAxisRun& RunB) { return RunA.Min < RunB.Min; });
+
+		// Written in place, the merged runs never get ahead of the ones still to read
+		FAxisRun Current = FAxisRun{Fixed, Line[0].Min, Line[0].Max};
+		for (int32 RunIndex = 1; RunIndex < Line.Num(); ++RunIndex)
+		{
+			if (Line[RunIndex].Min <= Current.Max + Tolerance)
+			{
+				Current.Max = FMath::Max(Current.Max, Line[RunIndex].Max);
+			}
+			else
+			{
+				InOutRuns[NumMerged++] = Current;
+				Current = FAxisRun{Fixed, Line[RunIndex].Min, Line[RunIndex].Max};
+			}
+		}
+		InOutRuns[NumMerged++] = Current;
+		LineStart = LineEnd;
+	}
+	InOutRuns.SetNum(NumMerged, EAllowShrinking::No);
+}
+
+void FDungeonCorridorRuns::AddJunctions(float Tolerance)
+{
+	for (const FAxisRun& Horizontal : HorizontalRuns)
+	{
+		// Vertical runs are sorted by X, only those between the ends of the horizontal one can meet it
+		const int32 First = Algo::LowerBound(VerticalRuns, Horizontal.Min - Tolerance, [](const FAxisRun& Run, float X) { return Run.Fixed < X; });
+		for (int32 VerticalIndex = First; VerticalIndex < VerticalRuns.Num() && VerticalRuns[VerticalIndex].Fixed <= Horizontal.Max + Tolerance; ++VerticalIndex)
+		{
+			const FAxisRun& Vertical = VerticalRuns[VerticalIndex];
+			if (Horizontal.Fixed < Vertical.Min - Tolerance || Horizontal.Fixed > Vertical.Max + Tolerance)
+			{
+				continue;
+			}
+
+			// Two arms is a plain corner, three a T and four a crossing
+			const int32 NumArms = int32(Vertical.Fixed - Horizontal.Min > Tolerance) + int32(Horizontal.Max - Vertical.Fixed > Tolerance)
+				+ int32(Horizontal.Fixed - Vertical.Min > Tolerance) + int32(Vertical.Max - Horizontal.Fixed > Tolerance);
+			if (NumArms >= 3)
+			{
+				Junctions.Add(FVector2f(Vertical.Fixed, Horizontal.Fixed));
+			}
+		}
+	}
+}
@@ -0,0 +1,50 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonLayout.h"
+
+// Corridor segments merged into maximal straight runs before they are spawned
+// Several MST edges often leave a room along the same axis, so their segments overlap or follow
+// each other. Collinear horizontal and vertical segments that overlap or touch become a single run,
+// the other segments only lose their exact duplicates.
+// Junctions are the points where three or four arms of axis-aligned runs meet, crossings and T's.
+class DUNGEONPROCEDURAL_API FDungeonCorridorRuns
+{
+public:
+	// Coordinates closer than this are the same, in cm
+	static constexpr float DefaultTolerance = 1.f;
+
+	// Rebuilds the runs and the junctions from scratch, the memory is kept between builds
+	void Build(TConstArrayView<FDungeonSegment> Segments, float Tolerance = DefaultTolerance);
+
+	void Reset();
+
+	// Horizontal runs, then vertical runs, then the other segments
+	const TArray<FDungeonSegment>& GetRuns() const { return Runs; }
+
+	const TArray<FVector2f>& GetJunctions() const { return Junctions; }
+
+private:
+	// Straight run along one axis, Fixed is its Y if horizontal and its X if vertical
+	struct FAxisRun
+	{
+		float Fixed;
+		float Min;
+		float Max;
+	};
+
+	// Sorts the runs by line then by start, and merges the overlapping runs of each line
+	static void MergeAxisRuns(TArray<FAxisRun>& InOutRuns, float Tolerance);
+
+	// Both arrays merged, vertical runs sorted by X
+	void AddJunctions(float Tolerance);
+
+	TArray<FAxisRun> HorizontalRuns;
+	TArray<FAxisRun> VerticalRuns;
+	TArray<FDungeonSegment> OtherSegments;
+
+	TArray<FDungeonSegment> Runs;
+	TArray<FVector2f> Junctions;
+};
@@ -0,0 +1,261 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonDebugDrawComponent.h"
+
+#include "Engine/EngineTypes.h"
+
+namespace
+{
+	// Lines never expire, the layers are cleared explicitly
+	constexpr float PersistentLifeTime = -1.f;
+}
+
+UDungeonDebugDrawComponent::UDungeonDebugDrawComponent()
+{
+	// Ticks only while some visible layer waits for a rebuild
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+	bTickInEditor = true;
+}
+
+void UDungeonDebugDrawComponent::SetTriangles(EDungeonDebugLayer Layer, TConstArrayView<FTriangle> Triangles, FColor Color)
+{
+	FLayer& Target = GetLayer(Layer);
+	Target.Lines.Reset(Triangles.Num() * 3);
+	Target.ShapeStarts.Reset(Triangles.Num());
+	for (const FTriangle& Triangle : Triangles)
+	{
+		AddTriangle(Layer, Triangle, Color);
+	}
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::SetEdges(EDungeonDebugLayer Layer, TConstArrayView<FTriangleEdge> Edges, FColor Color)
+{
+	FLayer& Target = GetLayer(Layer);
+	Target.Lines.Reset(Edges.Num());
+	Target.ShapeStarts.Reset(Edges.Num());
+	for (const FTriangleEdge& Edge : Edges)
+	{
+		AddLine(Layer, Edge.PointA, Edge.PointB, Color);
+	}
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::AddTriangle(EDungeonDebugLayer Layer, const FTriangle& Triangle, FColor Color)
+{
+	FLayer& Target = GetLayer(Layer);
+	const uint8 DepthPriority = Layer == EDungeonDebugLayer::Overlay ? SDPG_Foreground : SDPG_World;
+	BeginShape(Target);
+	Target.Lines.Emplace(Triangle.PointA, Triangle.PointB, Color, PersistentLifeTime, LineThickness, DepthPriority);
+	Target.Lines.Emplace(Triangle.PointB, Triangle.PointC, Color, PersistentLifeTime, LineThickness, DepthPriority);
+	Target.Lines.Emplace(Triangle.PointC, Triangle.PointA, Color, PersistentLifeTime, LineThickness, DepthPriority);
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::AddLine(EDungeonDebugLayer Layer, const FVector& Start, const FVector& End, FColor Color, float Thickness)
+{
+	FLayer& Target = GetLayer(Layer);
+	const uint8 DepthPriority = Layer == EDungeonDebugLayer::Overlay ? SDPG_Foreground : SDPG_World;
+	BeginShape(Target);
+	Target.Lines.Emplace(Start, End, Color, PersistentLifeTime, Thickness < 0 ? LineThickness : Thickness, DepthPriority);
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::AddCircle(EDungeonDebugLayer Layer, const FVector& Center, float Radius, FColor Color, int32 NumSegments, float Thickness)
+{
+	FLayer& Target = GetLayer(Layer);
+	const uint8 DepthPriority = Layer == EDungeonDebugLayer::Overlay ? SDPG_Foreground : SDPG_World;
+	NumSegments = FMath::Max(NumSegments, 3);
+	BeginShape(Target);
+
+	const float AngleStep = 2.f * UE_PI / NumSegments;
+	FVector Previous = Center + FVector(Radius, 0, 0);
+	for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+	{
+		const FVector Next = Center + FVector(FMath::Cos(AngleStep * Segment), FMath::Sin(AngleStep * Segment), 0) * Radius;
+		Target.Lines.Emplace(Previous, Next, Color, PersistentLifeTime, Thickness < 0 ? LineThickness : Thickness, DepthPriority);
+		Previous = Next;
+	}
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::ClearLayer(EDungeonDebugLayer Layer)
+{
+	FLayer& Target = GetLayer(Layer);
+	if (Target.Lines.Num() == 0 && Target.NumDrawnLines == 0)
+	{
+		return;
+	}
+
+	// Keeps the capacity, layers are usually refilled right away
+	Target.Lines.Reset();
+	Target.ShapeStarts.Reset();
+	MarkDirty(Target);
+}
+
+void UDungeonDebugDrawComponent::ClearAllLayers()
+{
+	for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		ClearLayer(EDungeonDebugLayer(LayerIndex));
+	}
+}
+
+void UDungeonDebugDrawComponent::SetLayerVisible(EDungeonDebugLayer Layer, bool bVisible)
+{
+	FLayer& Target = GetLayer(Layer);
+	if (Target.bVisible == bVisible)
+	{
+		return;
+	}
+
+	Target.bVisible = bVisible;
+	if (LayerBatches.IsValidIndex(int32(Layer)) && IsValid(LayerBatches[int32(Layer)]))
+	{
+		LayerBatches[int32(Layer)]->SetVisibility(bVisible);
+	}
+	if (bVisible && Target.bDirty)
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+bool UDungeonDebugDrawComponent::IsLayerVisible(EDungeonDebugLayer Layer) const
+{
+	return Layers[int32(Layer)].bVisible;
+}
+
+int32 UDungeonDebugDrawComponent::GetNumDrawnLines(EDungeonDebugLayer Layer) const
+{
+	return Layers[int32(Layer)].NumDrawnLines;
+}
+
+void UDungeonDebugDrawComponent::FlushLayers()
+{
+	if (!CreateLayerBatches())
+	{
+		return;
+	}
+
+	for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		if (Layers[LayerIndex].bDirty && Layers[LayerIndex].bVisible)
+		{
+			RebuildLayer(LayerIndex);
+		}
+	}
+
+	// Hidden dirty layers wake the tick up again once shown
+	SetComponentTickEnabled(false);
+}
+
+void UDungeonDebugDrawComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// Lines added before registration
+	for (const FLayer& Layer : Layers)
+	{
+		if (Layer.bDirty && Layer.bVisible)
+		{
+			SetComponentTickEnabled(true);
+			break;
+		}
+	}
+}
+
+void UDungeonDebugDrawComponent::OnUnregister()
+{
+	for (ULineBatchComponent* Batch : LayerBatches)
+	{
+		if (IsValid(Batch))
+		{
+			Batch->DestroyComponent();
+		}
+	}
+	LayerBatches.Reset();
+
+	// The lines are kept, new batches get them on the next flush
+	for (FLayer& Layer : Layers)
+	{
+		Layer.bDirty = true;
+		Layer.NumDrawnLines = 0;
+	}
+
+	Super::OnUnregister();
+}
+
+void UDungeonDebugDrawComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	FlushLayers();
+}
+
+void UDungeonDebugDrawComponent::MarkDirty(FLayer& Layer)
+{
+	// Already waiting for the tick, or for the layer to be shown
+	if (Layer.bDirty)
+	{
+		return;
+	}
+
+	Layer.bDirty = true;
+	if (Layer.bVisible && IsRegistered())
+	{
+		SetComponentTickEnabled(true);
+	}
+}
+
+bool UDungeonDebugDrawComponent::CreateLayerBatches()
+{
+	if (LayerBatches.Num() == Layers.Num())
+	{
+		return true;
+	}
+	if (!IsRegistered() || !GetOwner())
+	{
+		return false;
+	}
+
+	for (int32 LayerIndex = LayerBatches.Num(); LayerIndex < Layers.Num(); ++LayerIndex)
+	{
+		ULineBatchComponent* Batch = NewObject<ULineBatchComponent>(GetOwner(), NAME_None, RF_Transient);
+		Batch->SetupAttachment(this);
+		Batch->SetVisibility(Layers[LayerIndex].bVisible);
+		Batch->RegisterComponent();
+		LayerBatches.Add(Batch);
+	}
+	return true;
+}
+
+void UDungeonDebugDrawComponent::RebuildLayer(int32 LayerIndex)
+{
+	FLayer& Layer = Layers[LayerIndex];
+	ULineBatchComponent* Batch = LayerBatches[LayerIndex];
+	Layer.bDirty = false;
+	Batch->Flush();
+
+	// Level of detail: whole shapes are dropped at a fixed stride, which keeps the look of dense graphs
+	const int32 NumLines = Layer.Lines.Num();
+	const int32 Stride = MaxLinesPerLayer > 0 && NumLines > MaxLinesPerLayer ? FMath::DivideAndRoundUp(NumLines, MaxLinesPerLayer) : 1;
+	if (Stride == 1)
+	{
+		Layer.NumDrawnLines = NumLines;
+		Batch->DrawLines(Layer.Lines);
+		return;
+	}
+
+	TArray<FBatchedLine> Thinned;
+	Thinned.Reserve(NumLines / Stride + 64);
+	for (int32 Shape = 0; Shape < Layer.ShapeStarts.Num(); Shape += Stride)
+	{
+		const int32 Begin = Layer.ShapeStarts[Shape];
+		const int32 End = Shape + 1 < Layer.ShapeStarts.Num() ? Layer.ShapeStarts[Shape + 1] : NumLines;
+		Thinned.Append(Layer.Lines.GetData() + Begin, End - Begin);
+	}
+	Layer.NumDrawnLines = Thinned.Num();
+	Batch->DrawLines(Thinned);
+}
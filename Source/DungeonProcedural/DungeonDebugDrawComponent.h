@@ -0,0 +1,114 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/LineBatchComponent.h"
+#include "Components/SceneComponent.h"
+#include "DungeonProcedural/Triangle.h"
+#include "DungeonDebugDrawComponent.generated.h"
+
+// Groups of debug lines rebuilt independently of each other
+UENUM(BlueprintType)
+enum class EDungeonDebugLayer : uint8
+{
+	// Delaunay triangles
+	Triangles,
+
+	// Minimum spanning tree edges
+	Path,
+
+	// L-shaped corridor segments
+	Corridors,
+
+	// Highlights of the current step-by-step sub-step, drawn on top of the others
+	Overlay,
+
+	Num UMETA(Hidden)
+};
+
+/**
+ * Retained debug drawing of the dungeon graphs.
+ * Each layer keeps its lines in its own line batch, so redrawing the overlay does not resend the
+ * triangulation. Changes are applied once per frame from the component tick, and only to the visible
+ * layers that changed. Layers holding more than MaxLinesPerLayer lines only draw one shape out of N.
+ */
+UCLASS(ClassGroup = (Dungeon), meta = (BlueprintSpawnableComponent))
+class DUNGEONPROCEDURAL_API UDungeonDebugDrawComponent : public USceneComponent
+{
+	GENERATED_BODY()
+public:
+	UDungeonDebugDrawComponent();
+
+	// Replace the content of the layer, one shape per triangle or edge
+	void SetTriangles(EDungeonDebugLayer Layer, TConstArrayView<FTriangle> Triangles, FColor Color);
+	void SetEdges(EDungeonDebugLayer Layer, TConstArrayView<FTriangleEdge> Edges, FColor Color);
+
+	// Add one shape to the layer, a negative Thickness uses LineThickness
+	void AddTriangle(EDungeonDebugLayer Layer, const FTriangle& Triangle, FColor Color);
+	void AddLine(EDungeonDebugLayer Layer, const FVector& Start, const FVector& End, FColor Color, float Thickness = -1.f);
+
+	// Circle in the XY plane
+	void AddCircle(EDungeonDebugLayer Layer, const FVector& Center, float Radius, FColor Color, int32 NumSegments = 32, float Thickness = -1.f);
+
+	UFUNCTION(BlueprintCallable)
+	void ClearLayer(EDungeonDebugLayer Layer);
+
+	UFUNCTION(BlueprintCallable)
+	void ClearAllLayers();
+
+	// Hidden layers keep their lines, and are only rebuilt once shown again
+	UFUNCTION(BlueprintCallable)
+	void SetLayerVisible(EDungeonDebugLayer Layer, bool bVisible);
+
+	UFUNCTION(BlueprintPure)
+	bool IsLayerVisible(EDungeonDebugLayer Layer) const;
+
+	// Lines sent to the renderer by the last rebuild of the layer, after thinning
+	UFUNCTION(BlueprintPure)
+	int32 GetNumDrawnLines(EDungeonDebugLayer Layer) const;
+
+	// Applies the pending changes now instead of at the next tick
+	UFUNCTION(BlueprintCallable)
+	void FlushLayers();
+
+	// Width of the lines added without an explicit thickness
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Debug")
+	float LineThickness = 50.f;
+
+	// Above this many lines a layer keeps one shape out of every N, 0 never thins
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Dungeon Debug")
+	int32 MaxLinesPerLayer = 50000;
+
+	virtual void OnRegister() override;
+	virtual void OnUnregister() override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+	struct FLayer
+	{
+		// Every line of the layer, before thinning
+		TArray<FBatchedLine> Lines;
+
+		// First line of each shape, thinning keeps or drops whole shapes
+		TArray<int32> ShapeStarts;
+
+		bool bVisible = true;
+		bool bDirty = false;
+		int32 NumDrawnLines = 0;
+	};
+
+	FLayer& GetLayer(EDungeonDebugLayer Layer) { return Layers[int32(Layer)]; }
+	void BeginShape(FLayer& Layer) const { Layer.ShapeStarts.Add(Layer.Lines.Num()); }
+	void MarkDirty(FLayer& Layer);
+
+	// Creates the line batches on first use
+	bool CreateLayerBatches();
+	void RebuildLayer(int32 LayerIndex);
+
+	TStaticArray<FLayer, int32(EDungeonDebugLayer::Num)> Layers;
+
+	// One line batch per layer, attached to this component
+	UPROPERTY(Transient)
+	TArray<ULineBatchComponent*> LayerBatches;
+};
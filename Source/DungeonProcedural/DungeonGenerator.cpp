@@ -0,0 +1,648 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonGenerator.h"
+
+#include <atomic>
+
+#include "Algo/Sort.h"
+#include "HAL/PlatformTime.h"
+#include "DungeonProcedural/DungeonStats.h"
+#include "DungeonProcedural/MinimumSpanningTree.h"
+#include "DungeonProcedural/ParallelDelaunay.h"
+#include "DungeonProcedural/SpatialHashGrid.h"
+#include "Math/UnrealMathUtility.h"
+
+namespace
+{
+	// Stages release their scratch when done, the largest is the spanning tree:
+	// about three sorted edges per room plus the union-find, when every room is primary
+	constexpr SIZE_T ScratchBytesPerRoom = 3 * 8 + 2 * 4;
+}
+
+FDungeonGenerator::FDungeonGenerator(const FDungeonGenerationSettings& InSettings)
+	: Settings(InSettings)
+{
+	for (const FDungeonRoomTypeDesc& RoomType : Settings.RoomTypes)
+	{
+		TypeSampler.AddType(RoomType.Probability, RoomType.SizeMin, RoomType.SizeMax);
+	}
+}
+
+void FDungeonGenerator::Run()
+{
+	Run([](EDungeonStage) { return true; });
+}
+
+bool FDungeonGenerator::Run(TFunctionRef<bool(EDungeonStage)> BeforeStage)
+{
+	for (int32 Stage = 0; Stage < int32(EDungeonStage::Num); ++Stage)
+	{
+		if (!BeforeStage(EDungeonStage(Stage)))
+		{
+			return false;
+		}
+		RunStage(EDungeonStage(Stage));
+	}
+	UE_LOG(LogTemp, Verbose, TEXT("[DungeonGenerator] %d rooms, scratch high-water %llu bytes in %d block allocations."),
+		Layout.NumRooms(), uint64(Arena.GetHighWaterBytes()), Arena.GetNumBlockAllocations());
+	return true;
+}
+
+void FDungeonGenerator::RunStage(EDungeonStage Stage)
+{
+	switch (Stage)
+	{
+	case EDungeonStage::SampleRooms: SampleRooms(); break;
+	case EDungeonStage::ResolveOverlaps: ResolveRoomOverlaps(); break;
+	case EDungeonStage::Triangulate: Triangulate(); break;
+	case EDungeonStage::CreatePath: CreatePath(); break;
+	case EDungeonStage::EvolvePath: EvolvePath(); break;
+	case EDungeonStage::ClearSecondaryRooms: ClearSecondaryRooms(); break;
+	default: break;
+	}
+}
+
+bool FDungeonGenerator::RunStageSliced(EDungeonStage Stage, int32& Cursor, double EndTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(DungeonRunStageSliced);
+
+	// Runs Unit(Cursor) until End is reached or the time is up
+	auto RunUnits = [&Cursor, EndTime](int32 End, auto&& Unit)
+	{
+		while (Cursor < End)
+		{
+			Unit(Cursor++);
+			if (FPlatformTime::Seconds() >= EndTime)
+			{
+				break;
+			}
+		}
+		return Cursor >= End;
+	};
+
+	// Cursor 0 is the setup of the stages that need one, their units start at 1
+	switch (Stage)
+	{
+	case EDungeonStage::SampleRooms:
+	{
+		if (Cursor == 0)
+		{
+			BeginRun();
+			SliceStream = MakeStageStream(Settings.Seed, EDungeonStage::SampleRooms);
+		}
+		return RunUnits(Settings.NbRoom, [this](int32) { SampleRoom(SliceStream); });
+	}
+
+	case EDungeonStage::ResolveOverlaps:
+	{
+		if (Layout.NumRooms() < 2)
+		{
+			return true;
+		}
+		if (Cursor == 0)
+		{
+			SliceSolverSettings = FOverlapSolverSettings();
+			SliceSolverSettings.Seed = MakeStageStream(Settings.Seed, EDungeonStage::ResolveOverlaps).GetCurrentSeed();
+			SliceCellSize = ScatterStackedRooms(Layout.RoomCenters, Layout.RoomExtents, SliceSolverSettings, Arena);
+			++Cursor;
+		}
+
+		// One unit per separation pass, stops early once no room overlaps
+		while (Cursor <= SliceSolverSettings.MaxIterations)
+		{
+			++Cursor;
+			if (SeparateRooms(Layout.RoomCenters, Layout.RoomExtents, SliceSolverSettings, SliceCellSize, OverlapGrid) == 0)
+			{
+				return true;
+			}
+			if (FPlatformTime::Seconds() >= EndTime && Cursor <= SliceSolverSettings.MaxIterations)
+			{
+				return false;
+			}
+		}
+		UE_LOG(LogTemp, Warning, TEXT("Room overlaps not fully resolved after %d iterations."), SliceSolverSettings.MaxIterations);
+		return true;
+	}
+
+	case EDungeonStage::Triangulate:
+	{
+		if (Cursor == 0)
+		{
+			BeginTriangulate();
+		}
+		if (!RunUnits(TrianglePoints.Num() + 1, [this](int32 Unit) { if (Unit > 0) { InsertTrianglePoint(Unit - 1); } }))
+		{
+			return false;
+		}
+		if (TrianglePoints.Num() > 0)
+		{
+			FDelaunayMesh::PublishCounters(Mesh.GetCounters());
+			GetMeshPointTriangles(PointTriangles);
+			EndTriangulate();
+		}
+		return true;
+	}
+
+	case EDungeonStage::EvolvePath:
+	{
+		if (Cursor == 0)
+		{
+			BeginEvolvePath();
+			SliceStream = MakeStageStream(Settings.Seed, EDungeonStage::EvolvePath);
+		}
+		return RunUnits(Layout.PathEdges.Num() + 1, [this](int32 Unit) { if (Unit > 0) { AddCorridor(Layout.PathEdges[Unit - 1], SliceStream); } });
+	}
+
+	case EDungeonStage::ClearSecondaryRooms:
+	{
+		if (Cursor == 0)
+		{
+			BeginClearSecondaryRooms();
+		}
+		const int32 NumCulledRooms = Layout.CorridorSegments.Num() > 0 ? Layout.NumRooms() : 0;
+		if (!RunUnits(NumCulledRooms + 1, [this](int32 Unit)
+		{
+			if (Unit > 0)
+			{
+				// Stat macros compile out without STATS, keep the call outside of them
+				const int32 NumSegmentTests = ClearSecondaryRoom(Unit - 1);
+				INC_DWORD_STAT_BY(STAT_DungeonSegmentBoxTests, NumSegmentTests);
+			}
+		}))
+		{
+			return false;
+		}
+		EndClearSecondaryRooms();
+		return true;
+	}
+
+	default:
+		// The spanning tree is built in one go
+		RunStage(Stage);
+		++Cursor;
+		return true;
+	}
+}
+
+float FDungeonGenerator::GetStageProgress(EDungeonStage Stage, int32 Cursor) const
+{
+	int32 NumUnits = 1;
+	switch (Stage)
+	{
+	case EDungeonStage::SampleRooms: NumUnits = Settings.NbRoom; break;
+	// Passes needed grow roughly with the square root of the room count
+	case EDungeonStage::ResolveOverlaps: NumUnits = FMath::Clamp(FMath::CeilToInt32(0.5f * FMath::Sqrt(float(Layout.NumRooms()))), 8, SliceSolverSettings.MaxIterations) + 1; break;
+	case EDungeonStage::Triangulate: NumUnits = TrianglePoints.Num() + 1; break;
+	case EDungeonStage::EvolvePath: NumUnits = Layout.PathEdges.Num() + 1; break;
+	case EDungeonStage::ClearSecondaryRooms: NumUnits = Layout.NumRooms() + 1; break;
+	default: break;
+	}
+	return FMath::Clamp(float(Cursor) / float(FMath::Max(NumUnits, 1)), 0.f, 1.f);
+}
+
+void FDungeonGenerator::BeginRun()
+{
+	// One block sized for the whole run, a reused generator keeps it
+	Arena.Reset();
+	Arena.Reserve(ScratchBytesPerRoom * FMath::Max(Settings.NbRoom, 0));
+	Layout.Reset(Settings.NbRoom);
+}
+
+void FDungeonGenerator::SampleRooms()
+{
+	DUNGEON_SCOPE_STAGE(SampleRooms);
+	BeginRun();
+	const FRandomStream Random = MakeStageStream(Settings.Seed, EDungeonStage::SampleRooms);
+
+	// Types and scales of every room in one pass, then the per-room arrays sized once
+	TypeSampler.SampleRooms(Random, Settings.NbRoom, Layout.RoomTypeIds, Layout.RoomScales);
+	const int32 NumRooms = Layout.RoomTypeIds.Num();
+	Layout.RoomCenters.SetNumZeroed(NumRooms);
+	Layout.RoomExtents.SetNumUninitialized(NumRooms);
+	Layout.RoomKept.Init(true, NumRooms);
+
+	for (int32 RoomIndex = 0; RoomIndex < NumRooms; ++RoomIndex)
+	{
+		const FDungeonRoomTypeDesc& RoomType = Settings.RoomTypes[Layout.RoomTypeIds[RoomIndex]];
+		Layout.RoomExtents[RoomIndex] = RoomType.BaseExtent * Layout.RoomScales[RoomIndex];
+		if (RoomType.Role == EDungeonRoomRole::Primary)
+		{
+			Layout.PrimaryRooms.Add(RoomIndex);
+		}
+	}
+}
+
+void FDungeonGenerator::SampleRoom(const FRandomStream& Random)
+{
+	// Random scaling within the size range of the picked type
+	FVector2f Scale;
+	const int32 TypeId = TypeSampler.SampleRoom(Random, Scale);
+	if (TypeId == INDEX_NONE)
+	{
+		return;
+	}
+
+	const FDungeonRoomTypeDesc& RoomType = Settings.RoomTypes[TypeId];
+	const int32 RoomIndex = Layout.RoomCenters.Add(FVector2f::ZeroVector);
+	Layout.RoomExtents.Add(RoomType.BaseExtent * Scale);
+	Layout.RoomScales.Add(Scale);
+	Layout.RoomTypeIds.Add(TypeId);
+	Layout.RoomKept.Add(true);
+
+	if (RoomType.Role == EDungeonRoomRole::Primary)
+	{
+		Layout.PrimaryRooms.Add(RoomIndex);
+	}
+}
+
+void FDungeonGenerator::ResolveRoomOverlaps()
+{
+	FOverlapSolverSettings SolverSettings;
+	SolverSettings.Seed = MakeStageStream(Settings.Seed, EDungeonStage::ResolveOverlaps).GetCurrentSeed();
+	ResolveOverlaps(Layout.RoomCenters, Layout.RoomExtents, SolverSettings, OverlapGrid, Arena);
+}
+
+void FDungeonGenerator::Triangulate()
+{
+	DUNGEON_SCOPE_STAGE(Triangulate);
+	BeginTriangulate();
+	if (TrianglePoints.Num() == 0)
+	{
+		return;
+	}
+
+	// Triangles of the parallel path index TrianglePoints directly
+	if (!Settings.bParallelTriangulation || TrianglePoints.Num() < FParallelDelaunay::MinParallelPoints
+		|| !FParallelDelaunay::Triangulate(TrianglePoints, Mesh.GetVertex(0), Mesh.GetVertex(1), Mesh.GetVertex(2), PointTriangles))
+	{
+		for (int32 OrderIndex = 0; OrderIndex < InsertionOrder.Num(); ++OrderIndex)
+		{
+			InsertTrianglePoint(OrderIndex);
+		}
+		FDelaunayMesh::PublishCounters(Mesh.GetCounters());
+		GetMeshPointTriangles(PointTriangles);
+	}
+	EndTriangulate();
+}
+
+void FDungeonGenerator::BeginTriangulate()
+{
+	Layout.Triangles.Reset();
+	TrianglePoints.Reset(Layout.PrimaryRooms.Num());
+	InsertionOrder.Reset();
+	for (int32 RoomIndex : Layout.PrimaryRooms)
+	{
+		TrianglePoints.Add(FVector2D(Layout.RoomCenters[RoomIndex]));
+	}
+	if (TrianglePoints.Num() == 0)
+	{
+		return;
+	}
+
+	// Same super-triangle as URoomManager::MegaTriangle
+	FVector2D SuperA, SuperB, SuperC;
+	FDelaunayMesh::ComputeSuperTriangle(TrianglePoints, SuperA, SuperB, SuperC);
+	Mesh.Init(SuperA, SuperB, SuperC, TrianglePoints.Num());
+
+	// Insert along a Hilbert curve so each point location walk stays short
+	FDelaunayMesh::SortForInsertion(TrianglePoints, InsertionOrder, Arena);
+	PointByVertex.Init(INDEX_NONE, TrianglePoints.Num());
+}
+
+void FDungeonGenerator::InsertTrianglePoint(int32 OrderIndex)
+{
+	const int32 PointIndex = InsertionOrder[OrderIndex];
+	const int32 Vertex = Mesh.Insert(TrianglePoints[PointIndex]) - FDelaunayMesh::NumSuperVertices;
+	if (Vertex >= 0 && PointByVertex[Vertex] == INDEX_NONE)
+	{
+		PointByVertex[Vertex] = PointIndex;
+	}
+}
+
+void FDungeonGenerator::GetMeshPointTriangles(TArray<FIntVector>& OutPointTriangles) const
+{
+	// Triangles connected to the super-triangle are already dropped by the mesh
+	Mesh.GetTriangles(OutPointTriangles);
+	for (FIntVector& Tri : OutPointTriangles)
+	{
+		Tri = FIntVector(PointByVertex[Tri.X], PointByVertex[Tri.Y], PointByVertex[Tri.Z]);
+	}
+}
+
+void FDungeonGenerator::EndTriangulate()
+{
+	// Same order whichever path ran, so the spanning tree breaks ties the same way
+	FParallelDelaunay::SortTriangles(PointTriangles);
+	Layout.Triangles.Reserve(PointTriangles.Num());
+	for (const FIntVector& Tri : PointTriangles)
+	{
+		Layout.Triangles.Add(FIntVector(Layout.PrimaryRooms[Tri.X], Layout.PrimaryRooms[Tri.Y], Layout.PrimaryRooms[Tri.Z]));
+	}
+}
+
+void FDungeonGenerator::CreatePath()
+{
+	DUNGEON_SCOPE_STAGE(CreatePath);
+	Layout.PathEdges.Reset();
+	if (Layout.Triangles.Num() == 0)
+	{
+		return;
+	}
+
+	// Kruskal over the Delaunay edges, vertices are room indices
+	FMinimumSpanningTree::GetUniqueEdges(Layout.Triangles, UniqueEdges);
+	FMinimumSpanningTree::Build(Layout.RoomCenters, UniqueEdges, Layout.PathEdges, Arena);
+}
+
+void FDungeonGenerator::EvolvePath()
+{
+	DUNGEON_SCOPE_STAGE(EvolvePath);
+	BeginEvolvePath();
+	const FRandomStream Random = MakeStageStream(Settings.Seed, EDungeonStage::EvolvePath);
+	for (const FIntPoint& Edge : Layout.PathEdges)
+	{
+		AddCorridor(Edge, Random);
+	}
+}
+
+void FDungeonGenerator::BeginEvolvePath()
+{
+	// At most two segments per edge for L-shapes, routed corridors may need more
+	Layout.CorridorSegments.Reset(2 * Layout.PathEdges.Num());
+	if (Settings.bRouteCorridors)
+	{
+		Router.Init(Layout, Settings.RoutingCellSize, Settings.RoutingMaxExpansions);
+	}
+}
+
+void FDungeonGenerator::AddCorridor(const FIntPoint& Edge, const FRandomStream& Random)
+{
+	if (Settings.bRouteCorridors)
+	{
+		if (Router.Route(Layout, Edge.X, Edge.Y, Layout.CorridorSegments, Arena))
+		{
+			INC_DWORD_STAT(STAT_DungeonCorridorsRouted);
+			return;
+		}
+		INC_DWORD_STAT(STAT_DungeonRoutingFallbacks);
+	}
+
+	// Same tolerance as FTriangleEdge::IsStraightLine
+	constexpr float StraightTolerance = 50.f;
+	const int32 FirstSegment = Layout.CorridorSegments.Num();
+
+	const FVector2f& PointA = Layout.RoomCenters[Edge.X];
+	const FVector2f& PointB = Layout.RoomCenters[Edge.Y];
+
+	// If rooms are already aligned (horizontal or vertical), keep direct connection
+	if (FMath::IsNearlyEqual(PointA.X, PointB.X, StraightTolerance) || FMath::IsNearlyEqual(PointA.Y, PointB.Y, StraightTolerance))
+	{
+		Layout.CorridorSegments.Add(FDungeonSegment(PointA, PointB));
+	}
+	else
+	{
+		// Choose randomly between (A.x, B.y) and (B.x, A.y) for variation
+		const FVector2f Intersection = Random.FRand() < 0.5f ? FVector2f(PointA.X, PointB.Y) : FVector2f(PointB.X, PointA.Y);
+		Layout.CorridorSegments.Add(FDungeonSegment(PointA, Intersection));
+		Layout.CorridorSegments.Add(FDungeonSegment(Intersection, PointB));
+	}
+
+	// Routes found later may still merge into the fallback corridor
+	if (Settings.bRouteCorridors)
+	{
+		for (int32 SegmentIndex = FirstSegment; SegmentIndex < Layout.CorridorSegments.Num(); ++SegmentIndex)
+		{
+			Router.AddCorridor(Layout.CorridorSegments[SegmentIndex]);
+		}
+	}
+}
+
+void FDungeonGenerator::ClearSecondaryRooms()
+{
+	DUNGEON_SCOPE_STAGE(ClearSecondaryRooms);
+	BeginClearSecondaryRooms();
+	if (Layout.CorridorSegments.Num() > 0)
+	{
+		int32 NumSegmentTests = 0;
+		for (int32 RoomIndex = 0; RoomIndex < Layout.NumRooms(); ++RoomIndex)
+		{
+			NumSegmentTests += ClearSecondaryRoom(RoomIndex);
+		}
+		INC_DWORD_STAT_BY(STAT_DungeonSegmentBoxTests, NumSegmentTests);
+	}
+	EndClearSecondaryRooms();
+}
+
+void FDungeonGenerator::BeginClearSecondaryRooms()
+{
+	// Each room only visits the segments whose bounds overlap its box
+	if (Layout.CorridorSegments.Num() > 0)
+	{
+		CorridorBVH.Build(Layout.CorridorSegments);
+	}
+
+	const float CellSize = Settings.OccupancyCellSize > 0 ? Settings.OccupancyCellSize : FDungeonOccupancyGrid::ChooseCellSize(Layout.RoomExtents);
+	OccupancyGrid.InitFromLayout(Layout, CellSize);
+}
+
+int32 FDungeonGenerator::ClearSecondaryRoom(int32 RoomIndex)
+{
+	const FDungeonRoomTypeDesc& RoomType = Settings.RoomTypes[Layout.RoomTypeIds[RoomIndex]];
+	if (RoomType.Role != EDungeonRoomRole::Secondary || !Layout.RoomKept[RoomIndex])
+	{
+		return 0;
+	}
+
+	// No corridor cell under the box, no segment can touch it
+	const FVector2f& Center = Layout.RoomCenters[RoomIndex];
+	const FVector2f& Extent = Layout.RoomExtents[RoomIndex];
+	if (!OccupancyGrid.AnyInBox(FDungeonOccupancyGrid::ELayer::Corridor, Center, Extent))
+	{
+		Layout.RoomKept[RoomIndex] = false;
+		return 0;
+	}
+
+	int32 NumSegmentTests = 0;
+	Layout.RoomKept[RoomIndex] = CorridorBVH.IntersectsBox(Center, Extent, &NumSegmentTests);
+	return NumSegmentTests;
+}
+
+void FDungeonGenerator::EndClearSecondaryRooms()
+{
+	OccupancyGrid.AddRooms(Layout);
+}
+
+bool FDungeonGenerator::ResolveOverlaps(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings)
+{
+	FSpatialHashGrid Grid;
+	FDungeonArena Scratch;
+	return ResolveOverlaps(Centers, Extents, SolverSettings, Grid, Scratch);
+}
+
+bool FDungeonGenerator::ResolveOverlaps(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, FSpatialHashGrid& Grid, FDungeonArena& Scratch)
+{
+	DUNGEON_SCOPE_STAGE(ResolveOverlaps);
+	check(Centers.Num() == Extents.Num());
+
+	if (Centers.Num() < 2)
+	{
+		return true;
+	}
+
+	const float CellSize = ScatterStackedRooms(Centers, Extents, SolverSettings, Scratch);
+	for (int32 Iteration = 0; Iteration < SolverSettings.MaxIterations; ++Iteration)
+	{
+		if (SeparateRooms(Centers, Extents, SolverSettings, CellSize, Grid) == 0)
+		{
+			return true;
+		}
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("Room overlaps not fully resolved after %d iterations."), SolverSettings.MaxIterations);
+	return false;
+}
+
+float FDungeonGenerator::ScatterStackedRooms(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, FDungeonArena& Scratch)
+{
+	const int32 Num = Centers.Num();
+	float TotalArea = 0;
+	FVector2f Centroid = FVector2f::ZeroVector;
+	for (int32 Room = 0; Room < Num; ++Room)
+	{
+		TotalArea += 4 * Extents[Room].X * Extents[Room].Y;
+		Centroid += Centers[Room];
+	}
+	Centroid /= float(Num);
+
+	// Rooms stacked on the same center (all rooms start at the origin) cannot be
+	// separated along a penetration axis, scatter them in a disk first
+	const float ScatterRadius = FMath::Sqrt(SolverSettings.SpreadFactor * TotalArea / UE_PI);
+	const FRandomStream Random(SolverSettings.Seed);
+	const FDungeonArena::FMark Mark(Scratch);
+	TArrayView<int32> Order = Scratch.AllocateArray<int32>(Num);
+	for (int32 Room = 0; Room < Num; ++Room)
+	{
+		Order[Room] = Room;
+	}
+	Algo::Sort(Order, [&Centers](int32 A, int32 B)
+	{
+		return Centers[A].X != Centers[B].X ? Centers[A].X < Centers[B].X : Centers[A].Y < Centers[B].Y;
+	});
+	for (int32 SortedIndex = 1; SortedIndex < Num; ++SortedIndex)
+	{
+		if (Centers[Order[SortedIndex]] == Centers[Order[SortedIndex - 1]])
+		{
+			const float Angle = Random.FRandRange(0.f, 2 * UE_PI);
+			const float Radius = ScatterRadius * FMath::Sqrt(Random.FRand());
+			Centers[Order[SortedIndex - 1]] = Centroid + FVector2f(FMath::Cos(Angle), FMath::Sin(Angle)) * Radius;
+		}
+	}
+
+	// Cells about the size of the average room keep each query to a few candidates
+	return FMath::Max(FMath::Sqrt(TotalArea / Num), UE_KINDA_SMALL_NUMBER);
+}
+
+int32 FDungeonGenerator::SeparateRooms(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, float CellSize, FSpatialHashGrid& Grid)
+{
+	const int32 Num = Centers.Num();
+	INC_DWORD_STAT(STAT_DungeonOverlapIterations);
+	Grid.Build(Centers, Extents, CellSize);
+
+	// Gauss-Seidel pass: each overlapping pair is split along its minimum penetration axis
+	int32 NumOverlaps = 0;
+	for (int32 Room = 0; Room < Num; ++Room)
+	{
+		const FVector2f QueryExtent = Extents[Room] + FVector2f(SolverSettings.Margin);
+		Grid.Query(Centers[Room] - QueryExtent, Centers[Room] + QueryExtent, [&](int32 Other)
+		{
+			if (Other <= Room)
+			{
+				return;
+			}
+
+			const FVector2f Delta = Centers[Room] - Centers[Other];
+			const float PenetrationX = Extents[Room].X + Extents[Other].X + SolverSettings.Margin - FMath::Abs(Delta.X);
+			const float PenetrationY = Extents[Room].Y + Extents[Other].Y + SolverSettings.Margin - FMath::Abs(Delta.Y);
+			if (PenetrationX <= 0 || PenetrationY <= 0)
+			{
+				return;
+			}
+
+			++NumOverlaps;
+			const int32 Axis = PenetrationX < PenetrationY ? 0 : 1;
+			const float Penetration = Axis == 0 ? PenetrationX : PenetrationY;
+			const float Sign = Delta[Axis] > 0 || (Delta[Axis] == 0 && ((Room ^ Other) & 1)) ? 1.f : -1.f;
+
+			// Overshoot by half the margin so chains of touching rooms cannot keep
+			// pushing each other back by a rounding error forever
+			const float Push = 0.5f * (Penetration + 0.5f * SolverSettings.Margin);
+			Centers[Room][Axis] += Sign * Push;
+			Centers[Other][Axis] -= Sign * Push;
+		});
+	}
+	return NumOverlaps;
+}
+
+FRandomStream FDungeonGenerator::MakeStageStream(int32 Seed, EDungeonStage Stage)
+{
+	// SplitMix64 finalizer, consecutive seeds and stages give unrelated streams
+	uint64 Hash = (uint64(uint32(Seed)) << 8 | uint64(Stage)) + 0x9E3779B97F4A7C15ull;
+	Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+	Hash ^= Hash >> 31;
+	return FRandomStream(int32(uint32(Hash)));
+}
+
+int32 FDungeonGenerator::MakeRandomSeed()
+{
+	// Same finalizer over the cycle counter, the call count keeps calls within one tick apart
+	static std::atomic<uint64> NumCalls = 0;
+	uint64 Hash = FPlatformTime::Cycles64() + (NumCalls.fetch_add(1, std::memory_order_relaxed) + 1) * 0x9E3779B97F4A7C15ull;
+	Hash = (Hash ^ (Hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	Hash = (Hash ^ (Hash >> 27)) * 0x94D049BB133111EBull;
+	Hash ^= Hash >> 31;
+	return int32(Hash & MAX_int32);
+}
+
+bool FDungeonGenerator::IsSegmentIntersectingBox(const FVector2f& PointA, const FVector2f& PointB, const FVector2f& Center, const FVector2f& Extent)
+{
+	const FVector2f BoxMin = Center - Extent;
+	const FVector2f BoxMax = Center + Extent;
+
+	// Slab test on X and Y, clipped to the [0, 1] segment range
+	float TMin = 0.0f;
+	float TMax = 1.0f;
+	const FVector2f Direction = PointB - PointA;
+
+	for (int32 Axis = 0; Axis < 2; ++Axis)
+	{
+		if (FMath::Abs(Direction[Axis]) < KINDA_SMALL_NUMBER)
+		{
+			// Segment parallel to box faces
+			if (PointA[Axis] < BoxMin[Axis] || PointA[Axis] > BoxMax[Axis])
+			{
+				return false;
+			}
+		}
+		else
+		{
+			const float Ood = 1.0f / Direction[Axis];
+			float T1 = (BoxMin[Axis] - PointA[Axis]) * Ood;
+			float T2 = (BoxMax[Axis] - PointA[Axis]) * Ood;
+			if (T1 > T2)
+			{
+				Swap(T1, T2);
+			}
+
+			TMin = FMath::Max(TMin, T1);
+			TMax = FMath::Min(TMax, T2);
+			if (TMin > TMax)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,178 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DelaunayMesh.h"
+#include "DungeonProcedural/DungeonArena.h"
+#include "DungeonProcedural/DungeonCorridorRouter.h"
+#include "DungeonProcedural/DungeonLayout.h"
+#include "DungeonProcedural/DungeonOccupancyGrid.h"
+#include "DungeonProcedural/DungeonRoomSampler.h"
+#include "DungeonProcedural/SegmentBVH.h"
+#include "DungeonProcedural/SpatialHashGrid.h"
+
+// Pipeline stages, each one draws from its own random stream
+enum class EDungeonStage : uint8
+{
+	SampleRooms,
+	ResolveOverlaps,
+	Triangulate,
+	CreatePath,
+	EvolvePath,
+	ClearSecondaryRooms,
+	Num
+};
+
+// Tuning of the room separation solver
+struct FOverlapSolverSettings
+{
+	// Hard cap on separation passes, bounds the solver time
+	int32 MaxIterations = 256;
+
+	// Minimum gap kept between two rooms
+	float Margin = 1.f;
+
+	// Rooms sharing a center are scattered in a disk this many times the total room area
+	float SpreadFactor = 4.f;
+
+	// Seed of the stream used to scatter stacked rooms
+	int32 Seed = 0;
+};
+
+// Headless dungeon generation core
+// Runs the whole pipeline on flat arrays, without any UObject or actor.
+// URoomManager only materializes the final FDungeonLayout into actors.
+class DUNGEONPROCEDURAL_API FDungeonGenerator
+{
+public:
+	explicit FDungeonGenerator(const FDungeonGenerationSettings& InSettings);
+
+	// Runs every stage in pipeline order
+	void Run();
+
+	// Same as Run, but calls BeforeStage first and stops if it returns false
+	// Returns true if every stage ran.
+	bool Run(TFunctionRef<bool(EDungeonStage)> BeforeStage);
+
+	// Runs a single stage, stages must still be called in pipeline order
+	void RunStage(EDungeonStage Stage);
+
+	// Runs part of a stage, for frame-budgeted generation on the game thread
+	// Start each stage with Cursor = 0 and call again with the same Cursor until it returns true.
+	// Work units run until FPlatformTime::Seconds() reaches EndTime, and at least one runs per call.
+	// Gives the same layout as RunStage, the triangulation always takes the serial path.
+	bool RunStageSliced(EDungeonStage Stage, int32& Cursor, double EndTime);
+
+	// Estimated fraction of the stage done once RunStageSliced reached Cursor
+	float GetStageProgress(EDungeonStage Stage, int32 Cursor) const;
+
+	// Picks a type and a size for each room, all rooms start at the origin
+	void SampleRooms();
+
+	// Pushes rooms apart until no two boxes overlap
+	void ResolveRoomOverlaps();
+
+	// Delaunay triangulation of the primary room centers
+	void Triangulate();
+
+	// Minimum spanning tree over the Delaunay edges
+	void CreatePath();
+
+	// Converts MST edges into L-shaped corridors (horizontal + vertical segments)
+	// or, with bRouteCorridors, into corridors routed around the primary rooms
+	void EvolvePath();
+
+	// Culls secondary rooms that no corridor segment goes through
+	void ClearSecondaryRooms();
+
+	const FDungeonGenerationSettings& GetSettings() const { return Settings; }
+
+	// Seed of the next run, the scratch memory of the previous runs is kept
+	void SetSeed(int32 Seed) { Settings.Seed = Seed; }
+	const FDungeonLayout& GetLayout() const { return Layout; }
+	FDungeonLayout& GetLayout() { return Layout; }
+
+	// Kept rooms and corridors of the last run, built by ClearSecondaryRooms
+	const FDungeonOccupancyGrid& GetOccupancyGrid() const { return OccupancyGrid; }
+
+	// Scratch memory of the stages, its high-water mark is the peak temporary memory of a run
+	const FDungeonArena& GetScratchArena() const { return Arena; }
+
+	// Overlap solver shared with the actor-based URoomManager::ResolveRoomOverlaps
+	// Returns false if some rooms still overlap after SolverSettings.MaxIterations
+	static bool ResolveOverlaps(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings = FOverlapSolverSettings());
+
+	// Random stream of one stage, derived from the run seed only
+	// Stages never share a stream, so they can run on any thread in any order without changing results.
+	static FRandomStream MakeStageStream(int32 Seed, EDungeonStage Stage);
+
+	// Fresh seed in [0, MAX_int32] for requests that leave the seed to the generator
+	// Drawn from the cycle counter, unlike FMath::Rand which only gives 32768 values on some platforms.
+	static int32 MakeRandomSeed();
+
+	// 2D segment vs axis-aligned box test (Extent is the half size)
+	static bool IsSegmentIntersectingBox(const FVector2f& PointA, const FVector2f& PointB, const FVector2f& Center, const FVector2f& Extent);
+
+private:
+	// Single work units shared by the full and the sliced stages
+	void BeginRun();
+	void SampleRoom(const FRandomStream& Random);
+	void BeginTriangulate();
+	void InsertTrianglePoint(int32 OrderIndex);
+	void GetMeshPointTriangles(TArray<FIntVector>& OutPointTriangles) const;
+	void EndTriangulate();
+	void BeginEvolvePath();
+	void AddCorridor(const FIntPoint& Edge, const FRandomStream& Random);
+	void BeginClearSecondaryRooms();
+	// Returns the number of segments tested against the room
+	int32 ClearSecondaryRoom(int32 RoomIndex);
+	void EndClearSecondaryRooms();
+
+	// Scatters rooms stacked on the same center, returns the grid cell size for the separation passes
+	static float ScatterStackedRooms(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, FDungeonArena& Scratch);
+
+	// ResolveOverlaps with the grid and the scratch memory of the caller
+	static bool ResolveOverlaps(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, FSpatialHashGrid& Grid, FDungeonArena& Scratch);
+
+	// One Gauss-Seidel separation pass, returns the number of overlapping pairs found
+	static int32 SeparateRooms(TArray<FVector2f>& Centers, TConstArrayView<FVector2f> Extents, const FOverlapSolverSettings& SolverSettings, float CellSize, FSpatialHashGrid& Grid);
+
+	FDungeonGenerationSettings Settings;
+	FDungeonLayout Layout;
+
+	// Built once from Settings.RoomTypes
+	FDungeonRoomTypeSampler TypeSampler;
+
+	// Temporary buffers of the stages, reset at the start of each run
+	FDungeonArena Arena;
+
+	// Kept between runs so the triangulation reuses its buffers
+	FDelaunayMesh Mesh;
+
+	// Corridor segments, rebuilt by ClearSecondaryRooms
+	FSegmentBVH CorridorBVH;
+
+	// Culls most secondary rooms before the BVH is queried, then kept for lookups
+	FDungeonOccupancyGrid OccupancyGrid;
+
+	// Grid and search buffers of the corridor routing, kept between runs
+	FDungeonCorridorRouter Router;
+
+	// Triangulation input kept between insertions
+	TArray<FVector2D> TrianglePoints;
+	TArray<int32> InsertionOrder;
+	TArray<int32> PointByVertex;
+	TArray<FIntVector> PointTriangles;
+
+	// Delaunay edges fed to the spanning tree
+	TArray<FIntPoint> UniqueEdges;
+
+	// Broad phase of the separation passes
+	FSpatialHashGrid OverlapGrid;
+
+	// State carried between RunStageSliced calls
+	FRandomStream SliceStream;
+	FOverlapSolverSettings SliceSolverSettings;
+	float SliceCellSize = 0;
+};
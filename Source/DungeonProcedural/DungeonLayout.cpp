@@ -0,0 +1,70 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonLayout.h"
+
+void FDungeonLayout::Reset(int32 ExpectedRooms)
+{
+	RoomCenters.Reset(ExpectedRooms);
+	RoomExtents.Reset(ExpectedRooms);
+	RoomScales.Reset(ExpectedRooms);
+	RoomTypeIds.Reset(ExpectedRooms);
+	RoomKept.Reset(ExpectedRooms);
+	PrimaryRooms.Reset(ExpectedRooms);
+	Triangles.Reset();
+	PathEdges.Reset();
+	CorridorSegments.Reset();
+}
+
+void FDungeonLayout::ToTriangles(TArray<FTriangle>& OutTriangles) const
+{
+	OutTriangles.Reset(Triangles.Num());
+	for (const FIntVector& Tri : Triangles)
+	{
+		OutTriangles.Add(FTriangle(GetRoomLocation(Tri.X), GetRoomLocation(Tri.Y), GetRoomLocation(Tri.Z)));
+	}
+}
+
+void FDungeonLayout::ToPathEdges(TArray<FTriangleEdge>& OutEdges) const
+{
+	OutEdges.Reset(PathEdges.Num());
+	for (const FIntPoint& Edge : PathEdges)
+	{
+		OutEdges.Add(FTriangleEdge(GetRoomLocation(Edge.X), GetRoomLocation(Edge.Y)));
+	}
+}
+
+void FDungeonLayout::ToCorridorEdges(TArray<FTriangleEdge>& OutEdges) const
+{
+	OutEdges.Reset(CorridorSegments.Num());
+	for (const FDungeonSegment& Segment : CorridorSegments)
+	{
+		OutEdges.Add(FTriangleEdge(FVector(Segment.A.X, Segment.A.Y, 0), FVector(Segment.B.X, Segment.B.Y, 0)));
+	}
+}
+
+FDungeonLayoutView::FDungeonLayoutView(const FDungeonLayout& Layout)
+	: RoomCenters(Layout.RoomCenters)
+	, RoomExtents(Layout.RoomExtents)
+	, RoomScales(Layout.RoomScales)
+	, RoomTypeIds(Layout.RoomTypeIds)
+	, RoomKept(Layout.RoomKept)
+	, PrimaryRooms(Layout.PrimaryRooms)
+	, Triangles(Layout.Triangles)
+	, PathEdges(Layout.PathEdges)
+	, CorridorSegments(Layout.CorridorSegments)
+{
+}
+
+void FDungeonLayoutView::ToLayout(FDungeonLayout& OutLayout) const
+{
+	OutLayout.RoomCenters = RoomCenters;
+	OutLayout.RoomExtents = RoomExtents;
+	OutLayout.RoomScales = RoomScales;
+	OutLayout.RoomTypeIds = RoomTypeIds;
+	OutLayout.RoomKept = RoomKept;
+	OutLayout.PrimaryRooms = PrimaryRooms;
+	OutLayout.Triangles = Triangles;
+	OutLayout.PathEdges = PathEdges;
+	OutLayout.CorridorSegments = CorridorSegments;
+}
@@ -0,0 +1,147 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/Triangle.h"
+
+// Role of a room type in the generation pipeline
+enum class EDungeonRoomRole : uint8
+{
+	// Triangulated and connected by the minimum spanning tree
+	Primary,
+	// Kept only if a corridor runs through it
+	Secondary,
+	// Spawned as-is, never triangulated nor culled
+	Other
+};
+
+// Plain description of a room type used by the headless generator
+// Built once from FRoomType so the core never touches a UClass
+struct FDungeonRoomTypeDesc
+{
+	// Unscaled half size of the room box (BoxCollision extent)
+	FVector2f BaseExtent = FVector2f(50.f, 50.f);
+
+	// Weighted probability for room selection (higher = more likely)
+	float Probability = 1.f;
+
+	// Scale range for room size variation
+	float SizeMin = 1.f;
+	float SizeMax = 1.f;
+
+	EDungeonRoomRole Role = EDungeonRoomRole::Other;
+};
+
+// Input of a headless generation run
+struct FDungeonGenerationSettings
+{
+	int32 NbRoom = 0;
+
+	// Same seed and room types always give the same layout
+	int32 Seed = 0;
+
+	// Large triangulations are split across worker threads, the triangles are the same either way
+	bool bParallelTriangulation = true;
+
+	// Cell size of the occupancy grid built with the layout, 0 picks one from the room sizes
+	// Only changes the grid resolution, not the layout.
+	float OccupancyCellSize = 0.f;
+
+	// Corridors are routed on a grid around the primary rooms instead of random L-shapes
+	// Edges the router can't join within its budget still get an L-shape.
+	bool bRouteCorridors = false;
+
+	// Cell size of the routing grid, 0 picks one from the primary room sizes
+	float RoutingCellSize = 0.f;
+
+	// Search states the routing of a whole dungeon may expand, 0 gives a default per MST edge
+	int32 RoutingMaxExpansions = 0;
+
+	TArray<FDungeonRoomTypeDesc> RoomTypes;
+};
+
+// Corridor segment in world space (Z is always 0)
+struct FDungeonSegment
+{
+	FDungeonSegment() = default;
+	FDungeonSegment(const FVector2f& InA, const FVector2f& InB) : A(InA), B(InB) {}
+
+	FVector2f A = FVector2f::ZeroVector;
+	FVector2f B = FVector2f::ZeroVector;
+};
+
+// Flat, actor-free result of a generation run
+// Every per-room array shares the same index, triangles and MST edges store room indices
+struct DUNGEONPROCEDURAL_API FDungeonLayout
+{
+	// Room centers on the XY plane
+	TArray<FVector2f> RoomCenters;
+
+	// Scaled half sizes, equivalent to BoxCollision->GetScaledBoxExtent()
+	TArray<FVector2f> RoomExtents;
+
+	// Actor scale applied on X and Y when the room is materialized
+	TArray<FVector2f> RoomScales;
+
+	// Index into FDungeonGenerationSettings::RoomTypes
+	TArray<int32> RoomTypeIds;
+
+	// False once a secondary room has been culled
+	TArray<bool> RoomKept;
+
+	// Indices of the primary rooms, in insertion order for the triangulation
+	TArray<int32> PrimaryRooms;
+
+	// Delaunay triangles (super-triangle removed)
+	TArray<FIntVector> Triangles;
+
+	// Minimum spanning tree edges
+	TArray<FIntPoint> PathEdges;
+
+	// L-shaped corridor segments built from PathEdges
+	TArray<FDungeonSegment> CorridorSegments;
+
+	// Keeps the capacity, ExpectedRooms reserves the per-room arrays
+	void Reset(int32 ExpectedRooms = 0);
+
+	int32 NumRooms() const { return RoomCenters.Num(); }
+
+	FVector GetRoomLocation(int32 RoomIndex) const
+	{
+		return FVector(RoomCenters[RoomIndex].X, RoomCenters[RoomIndex].Y, 0);
+	}
+
+	// Conversions to the legacy geometry arrays exposed by URoomManager
+	void ToTriangles(TArray<FTriangle>& OutTriangles) const;
+	void ToPathEdges(TArray<FTriangleEdge>& OutEdges) const;
+	void ToCorridorEdges(TArray<FTriangleEdge>& OutEdges) const;
+};
+
+// Read-only view over the arrays of a layout, owned by an FDungeonLayout or a mapped layout file
+// Spawning takes a view, so a loaded file feeds it without any copy.
+struct DUNGEONPROCEDURAL_API FDungeonLayoutView
+{
+	FDungeonLayoutView() = default;
+	FDungeonLayoutView(const FDungeonLayout& Layout);
+
+	TConstArrayView<FVector2f> RoomCenters;
+	TConstArrayView<FVector2f> RoomExtents;
+	TConstArrayView<FVector2f> RoomScales;
+	TConstArrayView<int32> RoomTypeIds;
+	TConstArrayView<bool> RoomKept;
+	TConstArrayView<int32> PrimaryRooms;
+	TConstArrayView<FIntVector> Triangles;
+	TConstArrayView<FIntPoint> PathEdges;
+	TConstArrayView<FDungeonSegment> CorridorSegments;
+
+	int32 NumRooms() const { return RoomCenters.Num(); }
+
+	FVector GetRoomLocation(int32 RoomIndex) const
+	{
+		return FVector(RoomCenters[RoomIndex].X, RoomCenters[RoomIndex].Y, 0);
+	}
+
+	// Copies the viewed arrays into an owning layout
+	void ToLayout(FDungeonLayout& OutLayout) const;
+};
@@ -0,0 +1,144 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonLayoutCache.h"
+
+#include "DungeonProcedural/DungeonLayoutFile.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	// Bumped whenever the generator gives other layouts for the same settings
+	constexpr uint32 LayoutCacheVersion = 1;
+
+	template<typename T>
+	void AppendKeyBytes(TArray<uint8>& Bytes, const T& Value)
+	{
+		Bytes.Append(reinterpret_cast<const uint8*>(&Value), sizeof(T));
+	}
+}
+
+FDungeonLayoutCache::FDungeonLayoutCache(int32 InMaxEntries)
+	: Entries(FMath::Max(InMaxEntries, 1))
+	, MaxEntries(FMath::Max(InMaxEntries, 1))
+{
+}
+
+uint64 FDungeonLayoutCache::MakeKey(const FDungeonGenerationSettings& Settings, EDungeonStage LastStage)
+{
+	// Field by field, struct padding must not reach the hash
+	TArray<uint8> Bytes;
+	AppendKeyBytes(Bytes, LayoutCacheVersion);
+	AppendKeyBytes(Bytes, uint8(LastStage));
+	AppendKeyBytes(Bytes, Settings.NbRoom);
+	AppendKeyBytes(Bytes, Settings.Seed);
+	for (const FDungeonRoomTypeDesc& RoomType : Settings.RoomTypes)
+	{
+		AppendKeyBytes(Bytes, RoomType.BaseExtent.X);
+		AppendKeyBytes(Bytes, RoomType.BaseExtent.Y);
+		AppendKeyBytes(Bytes, RoomType.Probability);
+		AppendKeyBytes(Bytes, RoomType.SizeMin);
+		AppendKeyBytes(Bytes, RoomType.SizeMax);
+		AppendKeyBytes(Bytes, uint8(RoomType.Role));
+	}
+
+	// Only hashed when enabled, the keys of L-shaped layouts stay the same
+	if (Settings.bRouteCorridors)
+	{
+		AppendKeyBytes(Bytes, Settings.RoutingCellSize);
+		AppendKeyBytes(Bytes, Settings.RoutingMaxExpansions);
+	}
+	return CityHash64(reinterpret_cast<const char*>(Bytes.GetData()), Bytes.Num());
+}
+
+bool FDungeonLayoutCache::Find(uint64 Key, FDungeonLayout& OutLayout)
+{
+	FString Filename;
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (const FDungeonLayout* Cached = Entries.FindAndTouch(Key))
+		{
+			OutLayout = *Cached;
+			++Stats.MemoryHits;
+			return true;
+		}
+		Filename = GetFilename(Key);
+	}
+
+	// The file is read outside the lock, other threads keep hitting the memory tier meanwhile
+	// The layout is copied whole anyway, so the CRC check costs no extra page faults.
+	FDungeonLayoutFile File;
+	if (!Filename.IsEmpty() && FPaths::FileExists(Filename) && File.Open(Filename, true))
+	{
+		File.GetView().ToLayout(OutLayout);
+
+		FScopeLock ScopeLock(&Lock);
+		Entries.Add(Key, OutLayout);
+		++Stats.DiskHits;
+		return true;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	++Stats.Misses;
+	return false;
+}
+
+void FDungeonLayoutCache::Add(uint64 Key, const FDungeonLayout& Layout, int32 Seed)
+{
+	FString Filename;
+	{
+		FScopeLock ScopeLock(&Lock);
+		Entries.Add(Key, Layout);
+		Filename = GetFilename(Key);
+	}
+
+	// Written under a unique name, then renamed, so readers never map a half-written file
+	// When another thread or process wrote the same key meanwhile, its file is kept.
+	if (!Filename.IsEmpty() && !FPaths::FileExists(Filename))
+	{
+		const FString TempFilename = FPaths::CreateTempFilename(*FPaths::GetPath(Filename), TEXT("dlayout-"), TEXT(".tmp"));
+		if (!FDungeonLayoutFile::Save(Layout, Seed, TempFilename)
+			|| !IFileManager::Get().Move(*Filename, *TempFilename, false, false, false, true))
+		{
+			IFileManager::Get().Delete(*TempFilename, false, false, true);
+		}
+	}
+}
+
+void FDungeonLayoutCache::SetDirectory(const FString& InDirectory)
+{
+	FScopeLock ScopeLock(&Lock);
+	Directory = InDirectory;
+	if (!Directory.IsEmpty())
+	{
+		IFileManager::Get().MakeDirectory(*Directory, true);
+	}
+}
+
+void FDungeonLayoutCache::Empty()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Empty(MaxEntries);
+	Stats = FDungeonLayoutCacheStats();
+}
+
+FDungeonLayoutCacheStats FDungeonLayoutCache::GetStats() const
+{
+	FScopeLock ScopeLock(&Lock);
+	FDungeonLayoutCacheStats Result = Stats;
+	Result.NumEntries = Entries.Num();
+	return Result;
+}
+
+FString FDungeonLayoutCache::MakeFilename(const FString& InDirectory, uint64 Key)
+{
+	return FPaths::Combine(InDirectory, FString::Printf(TEXT("%016llx.dlayout"), Key));
+}
+
+FString FDungeonLayoutCache::GetFilename(uint64 Key) const
+{
+	return Directory.IsEmpty() ? FString() : MakeFilename(Directory, Key);
+}
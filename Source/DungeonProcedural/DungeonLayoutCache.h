@@ -0,0 +1,70 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/LruCache.h"
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "DungeonProcedural/DungeonLayout.h"
+#include "DungeonLayoutCache.generated.h"
+
+// Layout cache counters since the last Empty
+USTRUCT(BlueprintType)
+struct FDungeonLayoutCacheStats
+{
+	GENERATED_BODY()
+
+	// Layouts found in memory
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Cache")
+	int32 MemoryHits = 0;
+
+	// Layouts loaded from the cache directory
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Cache")
+	int32 DiskHits = 0;
+
+	// Layouts that had to be generated
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Cache")
+	int32 Misses = 0;
+
+	// Layouts held in memory
+	UPROPERTY(BlueprintReadOnly, Category="Dungeon Cache")
+	int32 NumEntries = 0;
+};
+
+// Finished layouts keyed by a hash of everything that shapes them
+// The most recently used layouts stay in memory, and every layout is also written to the cache
+// directory, if one is set, as a layout file. Safe to use from any thread.
+class DUNGEONPROCEDURAL_API FDungeonLayoutCache
+{
+public:
+	explicit FDungeonLayoutCache(int32 InMaxEntries = 16);
+
+	// Hash of the seed, the room count and the room types, for a pipeline run up to LastStage
+	// Whether the triangulation runs in parallel does not change the layout and is left out.
+	static uint64 MakeKey(const FDungeonGenerationSettings& Settings, EDungeonStage LastStage = EDungeonStage::ClearSecondaryRooms);
+
+	// Name of the layout file of Key in a cache directory, files written there by other tools are found too
+	static FString MakeFilename(const FString& InDirectory, uint64 Key);
+
+	// Copies the cached layout into OutLayout, looking in memory first, then on disk
+	bool Find(uint64 Key, FDungeonLayout& OutLayout);
+
+	void Add(uint64 Key, const FDungeonLayout& Layout, int32 Seed);
+
+	// Layout files go to this directory, an empty one disables the disk tier
+	void SetDirectory(const FString& InDirectory);
+
+	// Drops the layouts held in memory and resets the counters, files are kept
+	void Empty();
+
+	FDungeonLayoutCacheStats GetStats() const;
+
+private:
+	FString GetFilename(uint64 Key) const;
+
+	mutable FCriticalSection Lock;
+	TLruCache<uint64, FDungeonLayout> Entries;
+	int32 MaxEntries = 0;
+	FString Directory;
+	FDungeonLayoutCacheStats Stats;
+};
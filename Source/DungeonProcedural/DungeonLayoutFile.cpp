@@ -0,0 +1,192 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonLayoutFile.h"
+
+#include "Async/MappedFileHandle.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+
+static_assert(sizeof(FVector2f) == 8 && sizeof(FIntVector) == 12 && sizeof(FIntPoint) == 8 && sizeof(FDungeonSegment) == 16 && sizeof(bool) == 1,
+	"The layout file stores these types raw");
+
+namespace
+{
+	constexpr int32 SectionAlignment = 4;
+
+	template<typename T>
+	void WriteSection(TArray<uint8>& Bytes, TConstArrayView<T> Section)
+	{
+		Bytes.Append(reinterpret_cast<const uint8*>(Section.GetData()), Section.NumBytes());
+		Bytes.AddZeroed(Align(Bytes.Num(), SectionAlignment) - Bytes.Num());
+	}
+
+	// Points Section at the next Num elements and moves Offset past them, false if the data is too short
+	template<typename T>
+	bool ReadSection(TConstArrayView<uint8> Bytes, int64& Offset, int32 Num, TConstArrayView<T>& Section)
+	{
+		const int64 Size = int64(Num) * sizeof(T);
+		if (Num < 0 || Offset + Size > Bytes.Num())
+		{
+			return false;
+		}
+		Section = TConstArrayView<T>(reinterpret_cast<const T*>(Bytes.GetData() + Offset), Num);
+		Offset = Align(Offset + Size, SectionAlignment);
+		return true;
+	}
+
+	bool AreRoomIndices(TConstArrayView<int32> Indices, int32 NumRooms)
+	{
+		for (int32 Index : Indices)
+		{
+			if (uint32(Index) >= uint32(NumRooms))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+FDungeonLayoutFile::FDungeonLayoutFile() = default;
+
+FDungeonLayoutFile::~FDungeonLayoutFile()
+{
+	Close();
+}
+
+bool FDungeonLayoutFile::Open(const FString& Filename, bool bVerifyCrc)
+{
+	Close();
+
+	MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedHandle && MappedHandle->GetFileSize() > 0)
+	{
+		MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = TConstArrayView<uint8>(MappedRegion->GetMappedPtr(), int32(MappedRegion->GetMappedSize()));
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedBytes, *Filename, FILEREAD_Silent))
+	{
+		Data = LoadedBytes;
+	}
+
+	if (Data.Num() == 0 || !Parse(Data, View, Seed, bVerifyCrc))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not load dungeon layout %s."), *Filename);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FDungeonLayoutFile::Close()
+{
+	// The region must be unmapped before its file handle is closed
+	View = FDungeonLayoutView();
+	Data = TConstArrayView<uint8>();
+	MappedRegion.Reset();
+	MappedHandle.Reset();
+	LoadedBytes.Empty();
+	Seed = 0;
+}
+
+void FDungeonLayoutFile::Write(const FDungeonLayout& Layout, int32 Seed, TArray<uint8>& OutBytes)
+{
+	FDungeonLayoutFileHeader Header;
+	Header.Seed = Seed;
+	Header.NumRooms = Layout.NumRooms();
+	Header.NumPrimaryRooms = Layout.PrimaryRooms.Num();
+	Header.NumTriangles = Layout.Triangles.Num();
+	Header.NumPathEdges = Layout.PathEdges.Num();
+	Header.NumCorridorSegments = Layout.CorridorSegments.Num();
+
+	OutBytes.Reset();
+	OutBytes.AddZeroed(sizeof(FDungeonLayoutFileHeader));
+	WriteSection<FVector2f>(OutBytes, Layout.RoomCenters);
+	WriteSection<FVector2f>(OutBytes, Layout.RoomExtents);
+	WriteSection<FVector2f>(OutBytes, Layout.RoomScales);
+	WriteSection<int32>(OutBytes, Layout.RoomTypeIds);
+	WriteSection<bool>(OutBytes, Layout.RoomKept);
+	WriteSection<int32>(OutBytes, Layout.PrimaryRooms);
+	WriteSection<FIntVector>(OutBytes, Layout.Triangles);
+	WriteSection<FIntPoint>(OutBytes, Layout.PathEdges);
+	WriteSection<FDungeonSegment>(OutBytes, Layout.CorridorSegments);
+
+	Header.PayloadCrc = FCrc::MemCrc32(OutBytes.GetData() + sizeof(FDungeonLayoutFileHeader), OutBytes.Num() - sizeof(FDungeonLayoutFileHeader));
+	FMemory::Memcpy(OutBytes.GetData(), &Header, sizeof(FDungeonLayoutFileHeader));
+}
+
+bool FDungeonLayoutFile::Save(const FDungeonLayout& Layout, int32 Seed, const FString& Filename)
+{
+	TArray<uint8> Bytes;
+	Write(Layout, Seed, Bytes);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Filename))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Could not save dungeon layout %s."), *Filename);
+		return false;
+	}
+	return true;
+}
+
+bool FDungeonLayoutFile::Parse(TConstArrayView<uint8> Bytes, FDungeonLayoutView& OutView, int32& OutSeed, bool bVerifyCrc)
+{
+	if (Bytes.Num() < int32(sizeof(FDungeonLayoutFileHeader)))
+	{
+		return false;
+	}
+
+	FDungeonLayoutFileHeader Header;
+	FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(FDungeonLayoutFileHeader));
+	if (Header.Magic != FDungeonLayoutFileHeader::FileMagic || Header.Version != FDungeonLayoutFileHeader::CurrentVersion
+		|| Header.HeaderSize != sizeof(FDungeonLayoutFileHeader))
+	{
+		return false;
+	}
+
+	const uint8* Payload = Bytes.GetData() + sizeof(FDungeonLayoutFileHeader);
+	if (bVerifyCrc && FCrc::MemCrc32(Payload, Bytes.Num() - sizeof(FDungeonLayoutFileHeader)) != Header.PayloadCrc)
+	{
+		return false;
+	}
+
+	FDungeonLayoutView View;
+	int64 Offset = sizeof(FDungeonLayoutFileHeader);
+	const bool bComplete = ReadSection(Bytes, Offset, Header.NumRooms, View.RoomCenters)
+		&& ReadSection(Bytes, Offset, Header.NumRooms, View.RoomExtents)
+		&& ReadSection(Bytes, Offset, Header.NumRooms, View.RoomScales)
+		&& ReadSection(Bytes, Offset, Header.NumRooms, View.RoomTypeIds)
+		&& ReadSection(Bytes, Offset, Header.NumRooms, View.RoomKept)
+		&& ReadSection(Bytes, Offset, Header.NumPrimaryRooms, View.PrimaryRooms)
+		&& ReadSection(Bytes, Offset, Header.NumTriangles, View.Triangles)
+		&& ReadSection(Bytes, Offset, Header.NumPathEdges, View.PathEdges)
+		&& ReadSection(Bytes, Offset, Header.NumCorridorSegments, View.CorridorSegments);
+	if (!bComplete)
+	{
+		return false;
+	}
+
+	// Spawning trusts the data, flags must be real bools and indices must stay inside the rooms
+	for (const bool& bKept : View.RoomKept)
+	{
+		if (*reinterpret_cast<const uint8*>(&bKept) > 1)
+		{
+			return false;
+		}
+	}
+
+	const TConstArrayView<int32> TriangleIndices(reinterpret_cast<const int32*>(View.Triangles.GetData()), View.Triangles.Num() * 3);
+	const TConstArrayView<int32> EdgeIndices(reinterpret_cast<const int32*>(View.PathEdges.GetData()), View.PathEdges.Num() * 2);
+	if (!AreRoomIndices(View.PrimaryRooms, Header.NumRooms) || !AreRoomIndices(TriangleIndices, Header.NumRooms) || !AreRoomIndices(EdgeIndices, Header.NumRooms))
+	{
+		return false;
+	}
+
+	OutView = View;
+	OutSeed = Header.Seed;
+	return true;
+}
@@ -0,0 +1,74 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonLayout.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Binary layout file, little-endian
+// A fixed header, then each array of FDungeonLayout stored raw one after the other, every section
+// padded to 4 bytes. The sections have the in-memory layout of the arrays, so a mapped file is read in place.
+struct FDungeonLayoutFileHeader
+{
+	static constexpr uint32 FileMagic = 0x594C4744; // "DGLY"
+	static constexpr uint16 CurrentVersion = 1;
+
+	uint32 Magic = FileMagic;
+	uint16 Version = CurrentVersion;
+	uint16 HeaderSize = sizeof(FDungeonLayoutFileHeader);
+
+	// Seed the layout was generated with
+	int32 Seed = 0;
+
+	int32 NumRooms = 0;
+	int32 NumPrimaryRooms = 0;
+	int32 NumTriangles = 0;
+	int32 NumPathEdges = 0;
+	int32 NumCorridorSegments = 0;
+
+	// CRC32 of everything after the header, only checked on request as it reads every page
+	uint32 PayloadCrc = 0;
+};
+
+// Memory-mapped, read-only layout file
+// The view points into the mapping and stays valid as long as this object lives.
+class DUNGEONPROCEDURAL_API FDungeonLayoutFile
+{
+public:
+	FDungeonLayoutFile();
+	~FDungeonLayoutFile();
+
+	// Maps the file, or reads it whole where mapping is not supported
+	// Returns false if the file is missing, truncated, of another version or holds out of range indices.
+	// bVerifyCrc also checks the payload CRC, which faults in the whole mapping: meant for tools and
+	// for callers that copy the layout anyway.
+	bool Open(const FString& Filename, bool bVerifyCrc = false);
+
+	void Close();
+
+	bool IsOpen() const { return Data.Num() > 0; }
+
+	const FDungeonLayoutView& GetView() const { return View; }
+	int32 GetSeed() const { return Seed; }
+
+	// Writes a layout in the current version
+	static void Write(const FDungeonLayout& Layout, int32 Seed, TArray<uint8>& OutBytes);
+	static bool Save(const FDungeonLayout& Layout, int32 Seed, const FString& Filename);
+
+	// Checks the bytes and points OutView into them, nothing is copied
+	static bool Parse(TConstArrayView<uint8> Bytes, FDungeonLayoutView& OutView, int32& OutSeed, bool bVerifyCrc = false);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedHandle;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	// Fallback storage when the platform can't map the file
+	TArray<uint8> LoadedBytes;
+
+	TConstArrayView<uint8> Data;
+	FDungeonLayoutView View;
+	int32 Seed = 0;
+};
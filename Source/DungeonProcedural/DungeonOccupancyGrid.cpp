@@ -0,0 +1,193 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonOccupancyGrid.h"
+
+namespace
+{
+	// Bits FirstBit .. LastBit of a word, both in [0, 63]
+	uint64 BitRange(int32 FirstBit, int32 LastBit)
+	{
+		return (~uint64(0) << FirstBit) & (~uint64(0) >> (63 - LastBit));
+	}
+}
+
+void FDungeonOccupancyGrid::Init(const FVector2f& Min, const FVector2f& Max, float InCellSize)
+{
+	Origin = Min;
+	CellSize = FMath::Max(InCellSize, UE_KINDA_SMALL_NUMBER);
+	const FVector2f Size = FVector2f::Max(Max - Min, FVector2f::ZeroVector);
+
+	// One extra cell so points on the max border are still inside
+	auto NumCells = [](float InSize, float Axis) { return int64(FMath::FloorToDouble(double(Axis) / InSize)) + 1; };
+	int64 NumX = NumCells(CellSize, Size.X);
+	int64 NumY = NumCells(CellSize, Size.Y);
+	while (NumX * NumY > MaxCellsPerLayer)
+	{
+		CellSize *= FMath::Max(1.01f, FMath::Sqrt(float(NumX * NumY) / float(MaxCellsPerLayer)));
+		NumX = NumCells(CellSize, Size.X);
+		NumY = NumCells(CellSize, Size.Y);
+	}
+
+	InvCellSize = 1.f / CellSize;
+	Width = int32(NumX);
+	Height = int32(NumY);
+	WordsPerRow = (Width + 63) / 64;
+	Words.Reset();
+	Words.SetNumZeroed(int32(ELayer::Num) * Height * WordsPerRow);
+}
+
+void FDungeonOccupancyGrid::InitFromLayout(const FDungeonLayoutView& Layout, float InCellSize)
+{
+	FVector2f Min(UE_MAX_FLT, UE_MAX_FLT);
+	FVector2f Max(-UE_MAX_FLT, -UE_MAX_FLT);
+	for (int32 RoomIndex = 0; RoomIndex < Layout.NumRooms(); ++RoomIndex)
+	{
+		Min = FVector2f::Min(Min, Layout.RoomCenters[RoomIndex] - Layout.RoomExtents[RoomIndex]);
+		Max = FVector2f::Max(Max, Layout.RoomCenters[RoomIndex] + Layout.RoomExtents[RoomIndex]);
+	}
+	for (const FDungeonSegment& Segment : Layout.CorridorSegments)
+	{
+		Min = FVector2f::Min(Min, FVector2f::Min(Segment.A, Segment.B));
+		Max = FVector2f::Max(Max, FVector2f::Max(Segment.A, Segment.B));
+	}
+	if (Min.X > Max.X)
+	{
+		Reset();
+		return;
+	}
+
+	Init(Min, Max, InCellSize);
+	for (const FDungeonSegment& Segment : Layout.CorridorSegments)
+	{
+		AddSegment(ELayer::Corridor, Segment.A, Segment.B);
+	}
+}
+
+void FDungeonOccupancyGrid::AddRooms(const FDungeonLayoutView& Layout)
+{
+	for (int32 RoomIndex = 0; RoomIndex < Layout.NumRooms(); ++RoomIndex)
+	{
+		if (Layout.RoomKept[RoomIndex])
+		{
+			AddBox(ELayer::Room, Layout.RoomCenters[RoomIndex], Layout.RoomExtents[RoomIndex]);
+		}
+	}
+}
+
+void FDungeonOccupancyGrid::Build(const FDungeonLayoutView& Layout, float InCellSize)
+{
+	InitFromLayout(Layout, InCellSize);
+	AddRooms(Layout);
+}
+
+void FDungeonOccupancyGrid::Reset()
+{
+	Width = 0;
+	Height = 0;
+	WordsPerRow = 0;
+	Words.Reset();
+}
+
+void FDungeonOccupancyGrid::AddBox(ELayer Layer, const FVector2f& Center, const FVector2f& Extent)
+{
+	SetRange(Layer, GetCell(Center - Extent), GetCell(Center + Extent));
+}
+
+void FDungeonOccupancyGrid::AddSegment(ELayer Layer, const FVector2f& PointA, const FVector2f& PointB)
+{
+	// Corridors are axis aligned, their bounds are exactly the cells they cross
+	const FIntPoint CellA = GetCell(PointA);
+	const FIntPoint CellB = GetCell(PointB);
+	if (CellA.X == CellB.X || CellA.Y == CellB.Y)
+	{
+		SetRange(Layer, CellA.ComponentMin(CellB), CellA.ComponentMax(CellB));
+		return;
+	}
+
+	// Other segments one column at a time, the rows are widened by one cell to absorb the rounding
+	const FVector2f& Low = PointA.X <= PointB.X ? PointA : PointB;
+	const FVector2f& High = PointA.X <= PointB.X ? PointB : PointA;
+	const float Slope = (High.Y - Low.Y) / (High.X - Low.X);
+	const int32 MinX = FMath::Min(CellA.X, CellB.X);
+	const int32 MaxX = FMath::Max(CellA.X, CellB.X);
+	for (int32 X = MinX; X <= MaxX; ++X)
+	{
+		const float X0 = FMath::Max(Low.X, Origin.X + X * CellSize);
+		const float X1 = FMath::Min(High.X, Origin.X + (X + 1) * CellSize);
+		const float Y0 = Low.Y + (X0 - Low.X) * Slope;
+		const float Y1 = Low.Y + (X1 - Low.X) * Slope;
+		const int32 MinY = GetCell(FVector2f(X0, FMath::Min(Y0, Y1))).Y - 1;
+		const int32 MaxY = GetCell(FVector2f(X0, FMath::Max(Y0, Y1))).Y + 1;
+		SetRange(Layer, FIntPoint(X, MinY), FIntPoint(X, MaxY));
+	}
+}
+
+bool FDungeonOccupancyGrid::AnyInRange(ELayer Layer, const FIntPoint& MinCell, const FIntPoint& MaxCell) const
+{
+	const int32 MinX = FMath::Max(MinCell.X, 0);
+	const int32 MinY = FMath::Max(MinCell.Y, 0);
+	const int32 MaxX = FMath::Min(MaxCell.X, Width - 1);
+	const int32 MaxY = FMath::Min(MaxCell.Y, Height - 1);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return false;
+	}
+
+	const int32 FirstWord = MinX >> 6;
+	const int32 LastWord = MaxX >> 6;
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		const uint64* Row = GetRow(Layer, Y);
+		for (int32 Word = FirstWord; Word <= LastWord; ++Word)
+		{
+			const int32 FirstBit = Word == FirstWord ? (MinX & 63) : 0;
+			const int32 LastBit = Word == LastWord ? (MaxX & 63) : 63;
+			if (Row[Word] & BitRange(FirstBit, LastBit))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+float FDungeonOccupancyGrid::ChooseCellSize(TConstArrayView<FVector2f> Extents)
+{
+	if (Extents.Num() == 0)
+	{
+		return 100.f;
+	}
+
+	double Sum = 0;
+	for (const FVector2f& Extent : Extents)
+	{
+		Sum += FMath::Min(Extent.X, Extent.Y);
+	}
+	return FMath::Max(float(Sum / Extents.Num()), 1.f);
+}
+
+void FDungeonOccupancyGrid::SetRowRange(ELayer Layer, int32 Y, int32 MinX, int32 MaxX)
+{
+	uint64* Row = GetRow(Layer, Y);
+	const int32 FirstWord = MinX >> 6;
+	const int32 LastWord = MaxX >> 6;
+	for (int32 Word = FirstWord; Word <= LastWord; ++Word)
+	{
+		const int32 FirstBit = Word == FirstWord ? (MinX & 63) : 0;
+		const int32 LastBit = Word == LastWord ? (MaxX & 63) : 63;
+		Row[Word] |= BitRange(FirstBit, LastBit);
+	}
+}
+
+void FDungeonOccupancyGrid::SetRange(ELayer Layer, const FIntPoint& MinCell, const FIntPoint& MaxCell)
+{
+	const int32 MinX = FMath::Max(MinCell.X, 0);
+	const int32 MinY = FMath::Max(MinCell.Y, 0);
+	const int32 MaxX = FMath::Min(MaxCell.X, Width - 1);
+	const int32 MaxY = FMath::Min(MaxCell.Y, Height - 1);
+	for (int32 Y = MinY; Y <= MaxY && MinX <= MaxX; ++Y)
+	{
+		SetRowRange(Layer, Y, MinX, MaxX);
+	}
+}
@@ -0,0 +1,116 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonLayout.h"
+
+// Rooms and corridors of a layout rasterized on a uniform grid, one bit per cell and per layer
+// Each layer is stored as rows of 64-bit words: a point query reads one word, a box query one
+// word per row for boxes up to 64 cells wide.
+// Rasterization is conservative, every cell a box or a segment touches is set. An empty query
+// is exact, a set one is only a candidate for the exact test.
+// Queries are const and can run from several threads at once.
+class DUNGEONPROCEDURAL_API FDungeonOccupancyGrid
+{
+public:
+	enum class ELayer : uint8
+	{
+		Room,
+		Corridor,
+		Num
+	};
+
+	// Above this many cells per layer the cell size is grown, caps the grid at 16 MB
+	static constexpr int64 MaxCellsPerLayer = int64(1) << 26;
+
+	// Sizes the grid over [Min, Max] and clears every layer, the memory is kept between inits
+	void Init(const FVector2f& Min, const FVector2f& Max, float InCellSize);
+
+	// Init over the bounds of every room and corridor of the layout, then sets the corridor cells
+	void InitFromLayout(const FDungeonLayoutView& Layout, float InCellSize);
+
+	// Sets the cells of the kept rooms of the layout
+	void AddRooms(const FDungeonLayoutView& Layout);
+
+	// InitFromLayout then AddRooms
+	void Build(const FDungeonLayoutView& Layout, float InCellSize);
+
+	// Empties the grid, the memory is kept
+	void Reset();
+
+	// Extent is the half size
+	void AddBox(ELayer Layer, const FVector2f& Center, const FVector2f& Extent);
+	void AddSegment(ELayer Layer, const FVector2f& PointA, const FVector2f& PointB);
+
+	bool IsSet(ELayer Layer, const FIntPoint& Cell) const
+	{
+		if (Cell.X < 0 || Cell.Y < 0 || Cell.X >= Width || Cell.Y >= Height)
+		{
+			return false;
+		}
+		return (GetRow(Layer, Cell.Y)[Cell.X >> 6] >> (Cell.X & 63) & 1) != 0;
+	}
+
+	bool IsSetAt(ELayer Layer, const FVector2f& Point) const
+	{
+		return IsSet(Layer, GetCell(Point));
+	}
+
+	// True if any cell of the inclusive range [MinCell, MaxCell] is set
+	bool AnyInRange(ELayer Layer, const FIntPoint& MinCell, const FIntPoint& MaxCell) const;
+
+	// True if any cell touched by the box is set (Extent is the half size)
+	bool AnyInBox(ELayer Layer, const FVector2f& Center, const FVector2f& Extent) const
+	{
+		return AnyInRange(Layer, GetCell(Center - Extent), GetCell(Center + Extent));
+	}
+
+	// Cell of a point, points outside the grid land one cell past its border
+	FIntPoint GetCell(const FVector2f& Point) const
+	{
+		return FIntPoint(
+			FMath::FloorToInt32(FMath::Clamp((Point.X - Origin.X) * InvCellSize, -1.f, float(Width))),
+			FMath::FloorToInt32(FMath::Clamp((Point.Y - Origin.Y) * InvCellSize, -1.f, float(Height))));
+	}
+
+	FVector2f GetCellCenter(const FIntPoint& Cell) const
+	{
+		return Origin + (FVector2f(Cell.X, Cell.Y) + 0.5f) * CellSize;
+	}
+
+	float GetCellSize() const { return CellSize; }
+	FIntPoint GetSize() const { return FIntPoint(Width, Height); }
+	bool IsEmpty() const { return Width == 0; }
+	SIZE_T GetAllocatedSize() const { return Words.GetAllocatedSize(); }
+
+	// Cell size about the half size of an average room, so a room covers a few cells per axis
+	static float ChooseCellSize(TConstArrayView<FVector2f> Extents);
+
+private:
+	uint64* GetRow(ELayer Layer, int32 Y)
+	{
+		return &Words[(int32(Layer) * Height + Y) * WordsPerRow];
+	}
+
+	const uint64* GetRow(ELayer Layer, int32 Y) const
+	{
+		return &Words[(int32(Layer) * Height + Y) * WordsPerRow];
+	}
+
+	// Sets cells MinX .. MaxX of a row, the range must be inside the grid
+	void SetRowRange(ELayer Layer, int32 Y, int32 MinX, int32 MaxX);
+
+	// Sets every cell of the range clipped to the grid
+	void SetRange(ELayer Layer, const FIntPoint& MinCell, const FIntPoint& MaxCell);
+
+	FVector2f Origin = FVector2f::ZeroVector;
+	float CellSize = 1.f;
+	float InvCellSize = 1.f;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 WordsPerRow = 0;
+
+	// Layers one after the other, each one Height rows of WordsPerRow words
+	TArray<uint64> Words;
+};
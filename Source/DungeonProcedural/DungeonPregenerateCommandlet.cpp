@@ -0,0 +1,186 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonPregenerateCommandlet.h"
+
+#include "Algo/Count.h"
+#include "Async/ParallelFor.h"
+#include "DungeonProcedural/ConfigRoomDataAsset.h"
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "DungeonProcedural/DungeonLayoutCache.h"
+#include "DungeonProcedural/DungeonLayoutFile.h"
+#include "DungeonProcedural/RoomManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProperties.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+	// State kept by a worker across the seeds it runs, so the scratch memory and file buffer are reused
+	struct FPregenerateWorker
+	{
+		TUniquePtr<FDungeonGenerator> Generator;
+		TArray<uint8> FileBytes;
+	};
+}
+
+UDungeonPregenerateCommandlet::UDungeonPregenerateCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UDungeonPregenerateCommandlet::Main(const FString& Params)
+{
+	int32 NbRoom = 100;
+	int32 FirstSeed = 0;
+	int32 NumSeeds = 100;
+	FParse::Value(*Params, TEXT("Rooms="), NbRoom);
+	FParse::Value(*Params, TEXT("FirstSeed="), FirstSeed);
+	FParse::Value(*Params, TEXT("NumSeeds="), NumSeeds);
+	if (NbRoom <= 0 || NumSeeds <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Pregenerate] Rooms and NumSeeds must be positive."));
+		return 1;
+	}
+
+	// Defaults match the assets of the sample project
+	FString ConfigPath = TEXT("/Game/ConfigRoom.ConfigRoom");
+	FString PrimaryPath = TEXT("/Game/MainRoom.MainRoom_C");
+	FString SecondaryPath = TEXT("/Game/SecondaryRoom.SecondaryRoom_C");
+	FString OutputDirectory = FPaths::ProjectSavedDir() / TEXT("PregeneratedLayouts");
+	FParse::Value(*Params, TEXT("Config="), ConfigPath);
+	FParse::Value(*Params, TEXT("Primary="), PrimaryPath);
+	FParse::Value(*Params, TEXT("Secondary="), SecondaryPath);
+	FParse::Value(*Params, TEXT("Output="), OutputDirectory);
+
+	const UConfigRoomDataAsset* Config = LoadObject<UConfigRoomDataAsset>(nullptr, *ConfigPath);
+	if (!Config)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Pregenerate] Cannot load room config %s."), *ConfigPath);
+		return 1;
+	}
+	const TSubclassOf<ARoomParent> PrimaryRoom = LoadClass<ARoomParent>(nullptr, *PrimaryPath);
+	const TSubclassOf<ARoomParent> SecondaryRoom = LoadClass<ARoomParent>(nullptr, *SecondaryPath);
+	if (!PrimaryRoom)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[Pregenerate] Cannot load primary room class %s, layouts will have no corridor."), *PrimaryPath);
+	}
+	if (!IFileManager::Get().MakeDirectory(*OutputDirectory, true))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Pregenerate] Cannot create %s."), *OutputDirectory);
+		return 1;
+	}
+
+	// Every layout is generated on a single worker, the parallelism is across seeds
+	FDungeonGenerationSettings Settings = URoomManager::MakeGenerationSettings(NbRoom, Config->RoomTypes, PrimaryRoom, SecondaryRoom, FirstSeed);
+	Settings.bParallelTriangulation = false;
+
+	UE_LOG(LogTemp, Display, TEXT("[Pregenerate] %d layouts of %d rooms, seeds %d to %d, into %s"),
+		NumSeeds, NbRoom, FirstSeed, FirstSeed + NumSeeds - 1, *OutputDirectory);
+
+	TArray<FDungeonPregenerateResult> Results;
+	Results.SetNum(NumSeeds);
+	TArray<FPregenerateWorker> Workers;
+	const double StartTime = FPlatformTime::Seconds();
+	ParallelForWithTaskContext(TEXT("DungeonPregenerate"), Workers, NumSeeds,
+		[&Settings](int32, int32)
+		{
+			FPregenerateWorker Worker;
+			Worker.Generator = MakeUnique<FDungeonGenerator>(Settings);
+			return Worker;
+		},
+		[&Results, &OutputDirectory, FirstSeed](FPregenerateWorker& Worker, int32 Index)
+		{
+			FDungeonPregenerateResult& Result = Results[Index];
+			Result.Seed = FirstSeed + Index;
+			Worker.Generator->SetSeed(Result.Seed);
+			Result.Filename = FDungeonLayoutCache::MakeFilename(OutputDirectory, FDungeonLayoutCache::MakeKey(Worker.Generator->GetSettings()));
+
+			double Time = FPlatformTime::Seconds();
+			Worker.Generator->Run();
+			Result.GenerateMilliseconds = (FPlatformTime::Seconds() - Time) * 1000.0;
+
+			const FDungeonLayout& Layout = Worker.Generator->GetLayout();
+			Result.NumKeptRooms = Algo::Count(Layout.RoomKept, true);
+			Result.NumTriangles = Layout.Triangles.Num();
+			Result.NumCorridorSegments = Layout.CorridorSegments.Num();
+
+			Time = FPlatformTime::Seconds();
+			FDungeonLayoutFile::Write(Layout, Result.Seed, Worker.FileBytes);
+			Result.bWritten = FFileHelper::SaveArrayToFile(Worker.FileBytes, *Result.Filename);
+			Result.WriteMilliseconds = (FPlatformTime::Seconds() - Time) * 1000.0;
+			if (!Result.bWritten)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[Pregenerate] Could not save seed %d to %s."), Result.Seed, *Result.Filename);
+			}
+		});
+	const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+
+	const int32 NumWritten = Algo::CountIf(Results, [](const FDungeonPregenerateResult& Result) { return Result.bWritten; });
+	UE_LOG(LogTemp, Display, TEXT("[Pregenerate] %d/%d layouts written in %.2f s on %d workers (%.1f layouts/s)"),
+		NumWritten, NumSeeds, WallSeconds, Workers.Num(), NumSeeds / FMath::Max(WallSeconds, UE_DOUBLE_SMALL_NUMBER));
+
+	const FString SummaryPath = OutputDirectory / FString::Printf(TEXT("PregenerateSummary-%s.json"), *FDateTime::Now().ToString());
+	if (WriteSummary(SummaryPath, NbRoom, WallSeconds, Workers.Num(), Results))
+	{
+		UE_LOG(LogTemp, Display, TEXT("[Pregenerate] Summary written to %s"), *SummaryPath);
+	}
+	return NumWritten == NumSeeds ? 0 : 1;
+}
+
+bool UDungeonPregenerateCommandlet::WriteSummary(const FString& Path, int32 NbRoom, double WallSeconds, int32 NumWorkers, TConstArrayView<FDungeonPregenerateResult> Results)
+{
+	double TotalMilliseconds = 0;
+	double MaxMilliseconds = 0;
+	for (const FDungeonPregenerateResult& Result : Results)
+	{
+		TotalMilliseconds += Result.GenerateMilliseconds;
+		MaxMilliseconds = FMath::Max(MaxMilliseconds, Result.GenerateMilliseconds);
+	}
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	Writer->WriteObjectStart();
+	Writer->WriteValue(TEXT("Date"), FDateTime::UtcNow().ToIso8601());
+	Writer->WriteValue(TEXT("Platform"), FString(FPlatformProperties::IniPlatformName()));
+	Writer->WriteValue(TEXT("Configuration"), FString(LexToString(FApp::GetBuildConfiguration())));
+	Writer->WriteValue(TEXT("NbRoom"), NbRoom);
+	Writer->WriteValue(TEXT("NumLayouts"), Results.Num());
+	Writer->WriteValue(TEXT("NumWorkers"), NumWorkers);
+	Writer->WriteValue(TEXT("WallSeconds"), WallSeconds);
+	Writer->WriteValue(TEXT("AverageGenerateMilliseconds"), Results.Num() > 0 ? TotalMilliseconds / Results.Num() : 0.0);
+	Writer->WriteValue(TEXT("MaxGenerateMilliseconds"), MaxMilliseconds);
+
+	Writer->WriteArrayStart(TEXT("Layouts"));
+	for (const FDungeonPregenerateResult& Result : Results)
+	{
+		Writer->WriteObjectStart();
+		Writer->WriteValue(TEXT("Seed"), Result.Seed);
+		Writer->WriteValue(TEXT("File"), FPaths::GetCleanFilename(Result.Filename));
+		Writer->WriteValue(TEXT("GenerateMilliseconds"), Result.GenerateMilliseconds);
+		Writer->WriteValue(TEXT("WriteMilliseconds"), Result.WriteMilliseconds);
+		Writer->WriteValue(TEXT("NumKeptRooms"), Result.NumKeptRooms);
+		Writer->WriteValue(TEXT("NumTriangles"), Result.NumTriangles);
+		Writer->WriteValue(TEXT("NumCorridorSegments"), Result.NumCorridorSegments);
+		Writer->WriteValue(TEXT("Written"), Result.bWritten);
+		Writer->WriteObjectEnd();
+	}
+	Writer->WriteArrayEnd();
+	Writer->WriteObjectEnd();
+	Writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(Output, *Path))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[Pregenerate] Cannot write %s."), *Path);
+		return false;
+	}
+	return true;
+}
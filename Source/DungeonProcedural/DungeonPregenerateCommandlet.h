@@ -0,0 +1,44 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "DungeonPregenerateCommandlet.generated.h"
+
+// Timing and size of one pre-generated layout
+struct FDungeonPregenerateResult
+{
+	int32 Seed = 0;
+
+	// Layout file, named after the layout cache key
+	FString Filename;
+
+	double GenerateMilliseconds = 0;
+	double WriteMilliseconds = 0;
+
+	int32 NumKeptRooms = 0;
+	int32 NumTriangles = 0;
+	int32 NumCorridorSegments = 0;
+
+	bool bWritten = false;
+};
+
+// Generates a range of seeds on every core and writes each layout as a .dlayout file
+// No world and no actor, only FDungeonGenerator. Files are named by FDungeonLayoutCache::MakeKey,
+// so the output directory can be used as is as the layout cache directory of a server.
+//
+// UnrealEditor-Cmd <Project>.uproject -run=DungeonPregenerate -Rooms=200 -FirstSeed=0 -NumSeeds=1000
+//   [-Config=<data asset>] [-Primary=<class>] [-Secondary=<class>] [-Output=<directory>]
+UCLASS()
+class DUNGEONPROCEDURAL_API UDungeonPregenerateCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UDungeonPregenerateCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	// Writes the per-layout timings and their totals to Path as a JSON document
+	static bool WriteSummary(const FString& Path, int32 NbRoom, double WallSeconds, int32 NumWorkers, TConstArrayView<FDungeonPregenerateResult> Results);
+};
@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonRoomSampler.h"
+
+#include "Algo/BinarySearch.h"
+
+void FDungeonRoomTypeSampler::Reset()
+{
+	Cumulative.Reset();
+	SizeRanges.Reset();
+}
+
+void FDungeonRoomTypeSampler::AddType(float Probability, float SizeMin, float SizeMax)
+{
+	// Summed in the same order as the linear scan, so the bounds are bit-identical
+	Cumulative.Add(GetTotalProbability() + Probability);
+	SizeRanges.Add(FVector2f(SizeMin, SizeMax));
+}
+
+int32 FDungeonRoomTypeSampler::FindType(float Draw) const
+{
+	// First type whose cumulative bound is above the draw
+	const int32 TypeId = Algo::UpperBound(Cumulative, Draw);
+	return TypeId < Cumulative.Num() ? TypeId : INDEX_NONE;
+}
+
+int32 FDungeonRoomTypeSampler::SampleRoom(const FRandomStream& Random, FVector2f& OutScale) const
+{
+	const int32 TypeId = FindType(Random.FRandRange(0, GetTotalProbability()));
+	if (TypeId == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+
+	const FVector2f& SizeRange = SizeRanges[TypeId];
+	OutScale.X = Random.FRandRange(SizeRange.X, SizeRange.Y);
+	OutScale.Y = Random.FRandRange(SizeRange.X, SizeRange.Y);
+	return TypeId;
+}
+
+void FDungeonRoomTypeSampler::SampleRooms(const FRandomStream& Random, int32 NbRoom, TArray<int32>& OutTypeIds, TArray<FVector2f>& OutScales) const
+{
+	OutTypeIds.Reset(NbRoom);
+	OutScales.Reset(NbRoom);
+	for (int32 i = 0; i < NbRoom; ++i)
+	{
+		FVector2f Scale;
+		const int32 TypeId = SampleRoom(Random, Scale);
+		if (TypeId != INDEX_NONE)
+		{
+			OutTypeIds.Add(TypeId);
+			OutScales.Add(Scale);
+		}
+	}
+}
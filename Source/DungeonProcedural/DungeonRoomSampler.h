@@ -0,0 +1,35 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Weighted room type picker built once per room type list
+// Cumulative probabilities are searched by bisection, which picks exactly the type the linear
+// cumulative scan would for the same draw, so seeds keep giving the same dungeons.
+class DUNGEONPROCEDURAL_API FDungeonRoomTypeSampler
+{
+public:
+	void Reset();
+
+	// Types are indexed in the order they are added
+	void AddType(float Probability, float SizeMin, float SizeMax);
+
+	int32 NumTypes() const { return Cumulative.Num(); }
+	float GetTotalProbability() const { return Cumulative.Num() > 0 ? Cumulative.Last() : 0.f; }
+
+	// Type whose cumulative range holds Draw, in [0, GetTotalProbability()), INDEX_NONE past the last one
+	int32 FindType(float Draw) const;
+
+	// One room: a type, then a random scale on X and Y within its size range
+	// Returns INDEX_NONE without drawing the scale if no type was picked.
+	int32 SampleRoom(const FRandomStream& Random, FVector2f& OutScale) const;
+
+	// NbRoom rooms in one pass, same draws as NbRoom SampleRoom calls
+	// Rooms without a type are skipped, so the arrays may hold fewer than NbRoom entries.
+	void SampleRooms(const FRandomStream& Random, int32 NbRoom, TArray<int32>& OutTypeIds, TArray<FVector2f>& OutScales) const;
+
+private:
+	TArray<float> Cumulative;
+	TArray<FVector2f> SizeRanges;
+};
@@ -0,0 +1,39 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/DungeonStats.h"
+
+#include "HAL/IConsoleManager.h"
+
+DEFINE_STAT(STAT_DungeonSampleRooms);
+DEFINE_STAT(STAT_DungeonResolveOverlaps);
+DEFINE_STAT(STAT_DungeonTriangulate);
+DEFINE_STAT(STAT_DungeonCreatePath);
+DEFINE_STAT(STAT_DungeonEvolvePath);
+DEFINE_STAT(STAT_DungeonClearSecondaryRooms);
+DEFINE_STAT(STAT_DungeonSpawnRooms);
+DEFINE_STAT(STAT_DungeonSpawnCorridors);
+
+DEFINE_STAT(STAT_DungeonInCircleTests);
+DEFINE_STAT(STAT_DungeonTrianglesCreated);
+DEFINE_STAT(STAT_DungeonTrianglesRemoved);
+DEFINE_STAT(STAT_DungeonOverlapIterations);
+DEFINE_STAT(STAT_DungeonSegmentBoxTests);
+DEFINE_STAT(STAT_DungeonActorsSpawned);
+DEFINE_STAT(STAT_DungeonActorsReused);
+DEFINE_STAT(STAT_DungeonCorridorsRouted);
+DEFINE_STAT(STAT_DungeonRoutingFallbacks);
+DEFINE_STAT(STAT_DungeonCorridorSegmentsMerged);
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarDumpLayout(
+		TEXT("Dungeon.DumpLayout"),
+		false,
+		TEXT("Logs every triangle, spanning tree edge and corridor of the actor-based stages. Off by default, the logs cost more than the stages at scale."));
+}
+
+bool DungeonStats::IsLayoutDumpEnabled()
+{
+	return CVarDumpLayout.GetValueOnAnyThread();
+}
@@ -0,0 +1,43 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+// "stat Dungeon" in game, or the stats and cpu channels in Unreal Insights
+DECLARE_STATS_GROUP(TEXT("Dungeon"), STATGROUP_Dungeon, STATCAT_Advanced);
+
+// Pipeline stages, the headless and the actor-based versions share their stat
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sample Rooms"), STAT_DungeonSampleRooms, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resolve Overlaps"), STAT_DungeonResolveOverlaps, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Triangulate"), STAT_DungeonTriangulate, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Path"), STAT_DungeonCreatePath, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evolve Path"), STAT_DungeonEvolvePath, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Clear Secondary Rooms"), STAT_DungeonClearSecondaryRooms, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Rooms"), STAT_DungeonSpawnRooms, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Corridors"), STAT_DungeonSpawnCorridors, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+
+// Work done, reset every frame
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Incircle Tests"), STAT_DungeonInCircleTests, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles Created"), STAT_DungeonTrianglesCreated, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Triangles Removed"), STAT_DungeonTrianglesRemoved, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Overlap Iterations"), STAT_DungeonOverlapIterations, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Segment-Box Tests"), STAT_DungeonSegmentBoxTests, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Spawned"), STAT_DungeonActorsSpawned, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Actors Reused"), STAT_DungeonActorsReused, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Corridors Routed"), STAT_DungeonCorridorsRouted, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Routing Fallbacks"), STAT_DungeonRoutingFallbacks, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Corridor Segments Merged"), STAT_DungeonCorridorSegmentsMerged, STATGROUP_Dungeon, DUNGEONPROCEDURAL_API);
+
+// Cycle stat of a stage plus a cpu trace scope, which stays in builds compiled without stats
+#define DUNGEON_SCOPE_STAGE(Stage) \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Dungeon##Stage); \
+	SCOPE_CYCLE_COUNTER(STAT_Dungeon##Stage)
+
+namespace DungeonStats
+{
+	// Dungeon.DumpLayout: the logs listing every triangle, edge and corridor only run when it is set
+	DUNGEONPROCEDURAL_API bool IsLayoutDumpEnabled();
+}
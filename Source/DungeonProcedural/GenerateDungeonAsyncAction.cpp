@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/GenerateDungeonAsyncAction.h"
+
+#include "DungeonProcedural/RoomManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+UGenerateDungeonAsyncAction* UGenerateDungeonAsyncAction::GenerateDungeonAsync(UObject* WorldContextObject, int NbRoom,
+	const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS,
+	TSubclassOf<AActor> CorridorBP, int32 Seed)
+{
+	UGenerateDungeonAsyncAction* Action = NewObject<UGenerateDungeonAsyncAction>();
+	const UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	Action->RoomManager = World ? World->GetSubsystem<URoomManager>() : nullptr;
+	Action->NbRoom = NbRoom;
+	Action->RoomTypes = RoomTypes;
+	Action->RoomP = RoomP;
+	Action->RoomS = RoomS;
+	Action->CorridorBP = CorridorBP;
+	Action->Seed = Seed;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UGenerateDungeonAsyncAction::Activate()
+{
+	if (!RoomManager)
+	{
+		OnCancelled.Broadcast(0.f);
+		SetReadyToDestroy();
+		return;
+	}
+
+	RoomManager->OnGenerationProgress.AddDynamic(this, &UGenerateDungeonAsyncAction::HandleProgress);
+	RoomManager->OnGenerationFinished.AddDynamic(this, &UGenerateDungeonAsyncAction::HandleFinished);
+	RunId = RoomManager->GenerateDungeonAsync(NbRoom, RoomTypes, RoomP, RoomS, CorridorBP, Seed);
+}
+
+void UGenerateDungeonAsyncAction::HandleProgress(int32 InRunId, float Progress)
+{
+	if (InRunId == RunId)
+	{
+		OnProgress.Broadcast(Progress);
+	}
+}
+
+void UGenerateDungeonAsyncAction::HandleFinished(int32 InRunId, bool bCompleted)
+{
+	if (InRunId != RunId)
+	{
+		return;
+	}
+
+	RoomManager->OnGenerationProgress.RemoveDynamic(this, &UGenerateDungeonAsyncAction::HandleProgress);
+	RoomManager->OnGenerationFinished.RemoveDynamic(this, &UGenerateDungeonAsyncAction::HandleFinished);
+	if (bCompleted)
+	{
+		OnCompleted.Broadcast(1.f);
+	}
+	else
+	{
+		OnCancelled.Broadcast(0.f);
+	}
+	SetReadyToDestroy();
+}
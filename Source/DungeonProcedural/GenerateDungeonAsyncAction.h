@@ -0,0 +1,63 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/ConfigRoomDataAsset.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "GenerateDungeonAsyncAction.generated.h"
+
+class URoomManager;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FGenerateDungeonAsyncPin, float, Progress);
+
+// Latent Blueprint node over URoomManager::GenerateDungeonAsync
+UCLASS()
+class DUNGEONPROCEDURAL_API UGenerateDungeonAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, meta=(BlueprintInternalUseOnly="true", WorldContext="WorldContextObject"))
+	static UGenerateDungeonAsyncAction* GenerateDungeonAsync(UObject* WorldContextObject, int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, int32 Seed = -1);
+
+	// Fired on the game thread before each pipeline stage
+	UPROPERTY(BlueprintAssignable)
+	FGenerateDungeonAsyncPin OnProgress;
+
+	// Rooms and corridors are spawned
+	UPROPERTY(BlueprintAssignable)
+	FGenerateDungeonAsyncPin OnCompleted;
+
+	// ClearAll or another generation dropped this one
+	UPROPERTY(BlueprintAssignable)
+	FGenerateDungeonAsyncPin OnCancelled;
+
+	virtual void Activate() override;
+
+private:
+	UFUNCTION()
+	void HandleProgress(int32 InRunId, float Progress);
+
+	UFUNCTION()
+	void HandleFinished(int32 InRunId, bool bCompleted);
+
+	UPROPERTY()
+	URoomManager* RoomManager = nullptr;
+
+	UPROPERTY()
+	TArray<FRoomType> RoomTypes;
+
+	UPROPERTY()
+	TSubclassOf<ARoomParent> RoomP;
+
+	UPROPERTY()
+	TSubclassOf<ARoomParent> RoomS;
+
+	UPROPERTY()
+	TSubclassOf<AActor> CorridorBP;
+
+	int NbRoom = 0;
+	int32 Seed = -1;
+	int32 RunId = INDEX_NONE;
+};
@@ -0,0 +1,446 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/GeometryPredicates.h"
+
+#include <cmath>
+
+namespace
+{
+	// Half an ulp of 1.0 and the error bounds of the floating-point filters (Shewchuk)
+	constexpr double Epsilon = 1.1102230246251565e-16;
+	constexpr double CcwErrBoundA = (3.0 + 16.0 * Epsilon) * Epsilon;
+	constexpr double IccErrBoundA = (10.0 + 96.0 * Epsilon) * Epsilon;
+
+	// Largest expansion produced by multiplying two 16-term expansions
+	constexpr int32 MaxProductTerms = 512;
+
+	// Expansions are stored from the smallest to the largest magnitude component
+
+	FORCEINLINE void FastTwoSum(double A, double B, double& X, double& Y)
+	{
+		X = A + B;
+		Y = B - (X - A);
+	}
+
+	FORCEINLINE void TwoSum(double A, double B, double& X, double& Y)
+	{
+		X = A + B;
+		const double BVirt = X - A;
+		const double AVirt = X - BVirt;
+		Y = (A - AVirt) + (B - BVirt);
+	}
+
+	FORCEINLINE void TwoProduct(double A, double B, double& X, double& Y)
+	{
+		X = A * B;
+		Y = std::fma(A, B, -X);
+	}
+
+	// Exact A - B as an expansion of one or two terms
+	int32 Difference(double A, double B, double* H)
+	{
+		const double X = A - B;
+		const double BVirt = A - X;
+		const double AVirt = X + BVirt;
+		const double Y = (A - AVirt) + (BVirt - B);
+		if (Y == 0)
+		{
+			H[0] = X;
+			return 1;
+		}
+		H[0] = Y;
+		H[1] = X;
+		return 2;
+	}
+
+	int32 ScaleExpansion(const double* E, int32 ELen, double B, double* H)
+	{
+		int32 HLen = 0;
+		double Q, HH;
+		TwoProduct(E[0], B, Q, HH);
+		if (HH != 0)
+		{
+			H[HLen++] = HH;
+		}
+		for (int32 EIndex = 1; EIndex < ELen; ++EIndex)
+		{
+			double Product1, Product0, Sum;
+			TwoProduct(E[EIndex], B, Product1, Product0);
+			TwoSum(Q, Product0, Sum, HH);
+			if (HH != 0)
+			{
+				H[HLen++] = HH;
+			}
+			FastTwoSum(Product1, Sum, Q, HH);
+			if (HH != 0)
+			{
+				H[HLen++] = HH;
+			}
+		}
+		if (Q != 0 || HLen == 0)
+		{
+			H[HLen++] = Q;
+		}
+		return HLen;
+	}
+
+	// Sum of two expansions with zero elimination
+	int32 SumExpansions(const double* E, int32 ELen, const double* F, int32 FLen, double* H)
+	{
+		int32 EIndex = 0;
+		int32 FIndex = 0;
+		int32 HLen = 0;
+		double ENow = E[0];
+		double FNow = F[0];
+		double Q, QNew, HH;
+
+		auto NextE = [&]() { if (++EIndex < ELen) { ENow = E[EIndex]; } };
+		auto NextF = [&]() { if (++FIndex < FLen) { FNow = F[FIndex]; } };
+		auto TakeE = [&]() { return (FNow > ENow) == (FNow > -ENow); };
+
+		if (TakeE())
+		{
+			Q = ENow;
+			NextE();
+		}
+		else
+		{
+			Q = FNow;
+			NextF();
+		}
+
+		if (EIndex < ELen && FIndex < FLen)
+		{
+			if (TakeE())
+			{
+				FastTwoSum(ENow, Q, QNew, HH);
+				NextE();
+			}
+			else
+			{
+				FastTwoSum(FNow, Q, QNew, HH);
+				NextF();
+			}
+			Q = QNew;
+			if (HH != 0)
+			{
+				H[HLen++] = HH;
+			}
+
+			while (EIndex < ELen && FIndex < FLen)
+			{
+				if (TakeE())
+				{
+					TwoSum(Q, ENow, QNew, HH);
+					NextE();
+				}
+				else
+				{
+					TwoSum(Q, FNow, QNew, HH);
+					NextF();
+				}
+				Q = QNew;
+				if (HH != 0)
+				{
+					H[HLen++] = HH;
+				}
+			}
+		}
+
+		while (EIndex < ELen)
+		{
+			TwoSum(Q, ENow, QNew, HH);
+			NextE();
+			Q = QNew;
+			if (HH != 0)
+			{
+				H[HLen++] = HH;
+			}
+		}
+		while (FIndex < FLen)
+		{
+			TwoSum(Q, FNow, QNew, HH);
+			NextF();
+			Q = QNew;
+			if (HH != 0)
+			{
+				H[HLen++] = HH;
+			}
+		}
+
+		if (Q != 0 || HLen == 0)
+		{
+			H[HLen++] = Q;
+		}
+		return HLen;
+	}
+
+	// E must have at most 16 terms
+	int32 MultiplyExpansions(const double* E, int32 ELen, const double* F, int32 FLen, double* H)
+	{
+		check(ELen <= 16 && 2 * ELen * FLen <= MaxProductTerms);
+
+		double Scaled[32];
+		double Accumulators[2][MaxProductTerms];
+		int32 Current = 0;
+		int32 AccumulatorLen = ScaleExpansion(E, ELen, F[0], Accumulators[Current]);
+		for (int32 FIndex = 1; FIndex < FLen; ++FIndex)
+		{
+			const int32 ScaledLen = ScaleExpansion(E, ELen, F[FIndex], Scaled);
+			AccumulatorLen = SumExpansions(Accumulators[Current], AccumulatorLen, Scaled, ScaledLen, Accumulators[1 - Current]);
+			Current = 1 - Current;
+		}
+
+		FMemory::Memcpy(H, Accumulators[Current], AccumulatorLen * sizeof(double));
+		return AccumulatorLen;
+	}
+
+	void NegateExpansion(double* E, int32 ELen)
+	{
+		for (int32 Index = 0; Index < ELen; ++Index)
+		{
+			E[Index] = -E[Index];
+		}
+	}
+
+	// Exact A * B - C * D, each operand being an expansion of at most two terms
+	int32 CrossExpansion(const double* A, int32 ALen, const double* B, int32 BLen,
+		const double* C, int32 CLen, const double* D, int32 DLen, double* H)
+	{
+		double Left[8];
+		double Right[8];
+		const int32 LeftLen = MultiplyExpansions(A, ALen, B, BLen, Left);
+		const int32 RightLen = MultiplyExpansions(C, CLen, D, DLen, Right);
+		NegateExpansion(Right, RightLen);
+		return SumExpansions(Left, LeftLen, Right, RightLen, H);
+	}
+
+	double Orient2DExact(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+	{
+		double Acx[2], Bcy[2], Acy[2], Bcx[2];
+		const int32 AcxLen = Difference(A.X, C.X, Acx);
+		const int32 BcyLen = Difference(B.Y, C.Y, Bcy);
+		const int32 AcyLen = Difference(A.Y, C.Y, Acy);
+		const int32 BcxLen = Difference(B.X, C.X, Bcx);
+
+		double Det[16];
+		const int32 DetLen = CrossExpansion(Acx, AcxLen, Bcy, BcyLen, Acy, AcyLen, Bcx, BcxLen, Det);
+		return Det[DetLen - 1];
+	}
+
+	double InCircleExact(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+	{
+		double Adx[2], Ady[2], Bdx[2], Bdy[2], Cdx[2], Cdy[2];
+		const int32 AdxLen = Difference(A.X, D.X, Adx);
+		const int32 AdyLen = Difference(A.Y, D.Y, Ady);
+		const int32 BdxLen = Difference(B.X, D.X, Bdx);
+		const int32 BdyLen = Difference(B.Y, D.Y, Bdy);
+		const int32 CdxLen = Difference(C.X, D.X, Cdx);
+		const int32 CdyLen = Difference(C.Y, D.Y, Cdy);
+
+		// Lift * (cross product of the two other vertices), for each vertex
+		auto LiftedTerm = [](const double* Dx, int32 DxLen, const double* Dy, int32 DyLen, const double* Cross, int32 CrossLen, double* H)
+		{
+			double DxDx[8], DyDy[8], Lift[16];
+			const int32 DxDxLen = MultiplyExpansions(Dx, DxLen, Dx, DxLen, DxDx);
+			const int32 DyDyLen = MultiplyExpansions(Dy, DyLen, Dy, DyLen, DyDy);
+			const int32 LiftLen = SumExpansions(DxDx, DxDxLen, DyDy, DyDyLen, Lift);
+			return MultiplyExpansions(Lift, LiftLen, Cross, CrossLen, H);
+		};
+
+		double Cross[16];
+		double ATerm[MaxProductTerms], BTerm[MaxProductTerms], CTerm[MaxProductTerms];
+
+		int32 CrossLen = CrossExpansion(Bdx, BdxLen, Cdy, CdyLen, Cdx, CdxLen, Bdy, BdyLen, Cross);
+		const int32 ATermLen = LiftedTerm(Adx, AdxLen, Ady, AdyLen, Cross, CrossLen, ATerm);
+
+		CrossLen = CrossExpansion(Cdx, CdxLen, Ady, AdyLen, Adx, AdxLen, Cdy, CdyLen, Cross);
+		const int32 BTermLen = LiftedTerm(Bdx, BdxLen, Bdy, BdyLen, Cross, CrossLen, BTerm);
+
+		CrossLen = CrossExpansion(Adx, AdxLen, Bdy, BdyLen, Bdx, BdxLen, Ady, AdyLen, Cross);
+		const int32 CTermLen = LiftedTerm(Cdx, CdxLen, Cdy, CdyLen, Cross, CrossLen, CTerm);
+
+		double ABTerm[2 * MaxProductTerms];
+		double Det[3 * MaxProductTerms];
+		const int32 ABTermLen = SumExpansions(ATerm, ATermLen, BTerm, BTermLen, ABTerm);
+		const int32 DetLen = SumExpansions(ABTerm, ABTermLen, CTerm, CTermLen, Det);
+		return Det[DetLen - 1];
+	}
+}
+
+double FGeometryPredicates::Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	const double DetLeft = (A.X - C.X) * (B.Y - C.Y);
+	const double DetRight = (A.Y - C.Y) * (B.X - C.X);
+	const double Det = DetLeft - DetRight;
+
+	const double ErrBound = CcwErrBoundA * (FMath::Abs(DetLeft) + FMath::Abs(DetRight));
+	if (Det >= ErrBound || -Det >= ErrBound)
+	{
+		return Det;
+	}
+	return Orient2DExact(A, B, C);
+}
+
+double FGeometryPredicates::InCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+{
+	const double Adx = A.X - D.X;
+	const double Ady = A.Y - D.Y;
+	const double Bdx = B.X - D.X;
+	const double Bdy = B.Y - D.Y;
+	const double Cdx = C.X - D.X;
+	const double Cdy = C.Y - D.Y;
+
+	const double BdxCdy = Bdx * Cdy;
+	const double CdxBdy = Cdx * Bdy;
+	const double ALift = Adx * Adx + Ady * Ady;
+
+	const double CdxAdy = Cdx * Ady;
+	const double AdxCdy = Adx * Cdy;
+	const double BLift = Bdx * Bdx + Bdy * Bdy;
+
+	const double AdxBdy = Adx * Bdy;
+	const double BdxAdy = Bdx * Ady;
+	const double CLift = Cdx * Cdx + Cdy * Cdy;
+
+	const double Det = ALift * (BdxCdy - CdxBdy) + BLift * (CdxAdy - AdxCdy) + CLift * (AdxBdy - BdxAdy);
+	const double Permanent = (FMath::Abs(BdxCdy) + FMath::Abs(CdxBdy)) * ALift
+		+ (FMath::Abs(CdxAdy) + FMath::Abs(AdxCdy)) * BLift
+		+ (FMath::Abs(AdxBdy) + FMath::Abs(BdxAdy)) * CLift;
+
+	const double ErrBound = IccErrBoundA * Permanent;
+	if (Det > ErrBound || -Det > ErrBound)
+	{
+		return Det;
+	}
+	return InCircleExact(A, B, C, D);
+}
+
+bool FGeometryPredicates::IsInCircumcircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+{
+	const double Orientation = Orient2D(A, B, C);
+	if (Orientation > 0)
+	{
+		return InCircle(A, B, C, D) > 0;
+	}
+	if (Orientation < 0)
+	{
+		return InCircle(A, C, B, D) > 0;
+	}
+
+	// Degenerate triangle: no circumcircle
+	return false;
+}
+
+void FInCircleBatch::Reset(int32 ExpectedTriangles)
+{
+	NumTriangles = 0;
+	for (TArray<double>* Component : {&AX, &AY, &BX, &BY, &CX, &CY})
+	{
+		Component->Reset(ExpectedTriangles);
+	}
+	DegenerateTriangles.Reset();
+}
+
+void FInCircleBatch::Add(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	const double Orientation = FGeometryPredicates::Orient2D(A, B, C);
+	if (Orientation == 0)
+	{
+		DegenerateTriangles.Add(NumTriangles);
+	}
+
+	const FVector2D& First = Orientation < 0 ? C : B;
+	const FVector2D& Second = Orientation < 0 ? B : C;
+	AX.Add(A.X);
+	AY.Add(A.Y);
+	BX.Add(First.X);
+	BY.Add(First.Y);
+	CX.Add(Second.X);
+	CY.Add(Second.Y);
+	++NumTriangles;
+}
+
+void FInCircleBatch::TestPoint(const FVector2D& Point, TArray<bool>& OutInside) const
+{
+	OutInside.SetNumUninitialized(NumTriangles);
+
+	const VectorRegister4Double PX = MakeVectorRegisterDouble(Point.X, Point.X, Point.X, Point.X);
+	const VectorRegister4Double PY = MakeVectorRegisterDouble(Point.Y, Point.Y, Point.Y, Point.Y);
+	const VectorRegister4Double ErrBoundFactor = MakeVectorRegisterDouble(IccErrBoundA, IccErrBoundA, IccErrBoundA, IccErrBoundA);
+
+	// Four triangles per iteration, same filter as FGeometryPredicates::InCircle
+	int32 Index = 0;
+	for (; Index + 4 <= NumTriangles; Index += 4)
+	{
+		const VectorRegister4Double Adx = VectorSubtract(VectorLoad(&AX[Index]), PX);
+		const VectorRegister4Double Ady = VectorSubtract(VectorLoad(&AY[Index]), PY);
+		const VectorRegister4Double Bdx = VectorSubtract(VectorLoad(&BX[Index]), PX);
+		const VectorRegister4Double Bdy = VectorSubtract(VectorLoad(&BY[Index]), PY);
+		const VectorRegister4Double Cdx = VectorSubtract(VectorLoad(&CX[Index]), PX);
+		const VectorRegister4Double Cdy = VectorSubtract(VectorLoad(&CY[Index]), PY);
+
+		const VectorRegister4Double BdxCdy = VectorMultiply(Bdx, Cdy);
+		const VectorRegister4Double CdxBdy = VectorMultiply(Cdx, Bdy);
+		const VectorRegister4Double ALift = VectorAdd(VectorMultiply(Adx, Adx), VectorMultiply(Ady, Ady));
+
+		const VectorRegister4Double CdxAdy = VectorMultiply(Cdx, Ady);
+		const VectorRegister4Double AdxCdy = VectorMultiply(Adx, Cdy);
+		const VectorRegister4Double BLift = VectorAdd(VectorMultiply(Bdx, Bdx), VectorMultiply(Bdy, Bdy));
+
+		const VectorRegister4Double AdxBdy = VectorMultiply(Adx, Bdy);
+		const VectorRegister4Double BdxAdy = VectorMultiply(Bdx, Ady);
+		const VectorRegister4Double CLift = VectorAdd(VectorMultiply(Cdx, Cdx), VectorMultiply(Cdy, Cdy));
+
+		const VectorRegister4Double Det = VectorAdd(
+			VectorAdd(
+				VectorMultiply(ALift, VectorSubtract(BdxCdy, CdxBdy)),
+				VectorMultiply(BLift, VectorSubtract(CdxAdy, AdxCdy))),
+			VectorMultiply(CLift, VectorSubtract(AdxBdy, BdxAdy)));
+
+		const VectorRegister4Double Permanent = VectorAdd(
+			VectorAdd(
+				VectorMultiply(VectorAdd(VectorAbs(BdxCdy), VectorAbs(CdxBdy)), ALift),
+				VectorMultiply(VectorAdd(VectorAbs(CdxAdy), VectorAbs(AdxCdy)), BLift)),
+			VectorMultiply(VectorAdd(VectorAbs(AdxBdy), VectorAbs(BdxAdy)), CLift));
+
+		const VectorRegister4Double ErrBound = VectorMultiply(Permanent, ErrBoundFactor);
+		const int32 InsideMask = VectorMaskBits(VectorCompareGT(Det, ErrBound));
+		const int32 OutsideMask = VectorMaskBits(VectorCompareGT(VectorNegate(Det), ErrBound));
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const int32 TriangleIndex = Index + Lane;
+			if (InsideMask & (1 << Lane))
+			{
+				OutInside[TriangleIndex] = true;
+			}
+			else if (OutsideMask & (1 << Lane))
+			{
+				OutInside[TriangleIndex] = false;
+			}
+			else
+			{
+				// The filter cannot decide, use the exact predicate for this lane only
+				OutInside[TriangleIndex] = FGeometryPredicates::InCircle(
+					FVector2D(AX[TriangleIndex], AY[TriangleIndex]),
+					FVector2D(BX[TriangleIndex], BY[TriangleIndex]),
+					FVector2D(CX[TriangleIndex], CY[TriangleIndex]), Point) > 0;
+			}
+		}
+	}
+
+	for (; Index < NumTriangles; ++Index)
+	{
+		OutInside[Index] = FGeometryPredicates::InCircle(
+			FVector2D(AX[Index], AY[Index]),
+			FVector2D(BX[Index], BY[Index]),
+			FVector2D(CX[Index], CY[Index]), Point) > 0;
+	}
+
+	for (int32 TriangleIndex : DegenerateTriangles)
+	{
+		OutInside[TriangleIndex] = false;
+	}
+}
@@ -0,0 +1,47 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Robust 2D orientation and incircle predicates
+// A fast floating-point evaluation is used when its error bound proves the sign,
+// otherwise the determinant is recomputed exactly with stack-only expansion arithmetic.
+// No sqrt, no division and no heap allocation.
+struct DUNGEONPROCEDURAL_API FGeometryPredicates
+{
+	// > 0 if C is on the left of A->B (A, B, C counter-clockwise), < 0 on the right, 0 if collinear
+	static double Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+
+	// > 0 if D is strictly inside the circumcircle of the counter-clockwise triangle A, B, C,
+	// < 0 if outside, 0 if the four points are cocircular
+	static double InCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D);
+
+	// Same as InCircle, whatever the orientation of A, B, C
+	static bool IsInCircumcircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D);
+};
+
+// Structure-of-arrays batch of triangles tested against one point at a time
+// Four triangles are filtered per SIMD register, only uncertain lanes fall back to the exact predicate.
+class DUNGEONPROCEDURAL_API FInCircleBatch
+{
+public:
+	void Reset(int32 ExpectedTriangles = 0);
+
+	// Adds a triangle, its vertices are reordered counter-clockwise if needed
+	void Add(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+
+	int32 Num() const { return NumTriangles; }
+
+	// OutInside[i] is true if Point is strictly inside the circumcircle of triangle i
+	void TestPoint(const FVector2D& Point, TArray<bool>& OutInside) const;
+
+private:
+	int32 NumTriangles = 0;
+
+	// Vertex coordinates, one array per component
+	TArray<double> AX, AY, BX, BY, CX, CY;
+
+	// Collinear triangles never contain any point
+	TArray<int32> DegenerateTriangles;
+};
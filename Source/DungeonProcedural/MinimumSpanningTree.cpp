@@ -0,0 +1,119 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/MinimumSpanningTree.h"
+
+#include "Algo/Sort.h"
+#include "Algo/Unique.h"
+#include "DungeonProcedural/DungeonArena.h"
+
+namespace
+{
+	// Disjoint sets with path halving and union by size
+	struct FUnionFind
+	{
+		TArrayView<int32> Parent;
+		TArrayView<int32> Size;
+
+		FUnionFind(int32 Num, FDungeonArena& Scratch)
+			: Parent(Scratch.AllocateArray<int32>(Num))
+			, Size(Scratch.AllocateArray<int32>(Num))
+		{
+			for (int32 Index = 0; Index < Num; ++Index)
+			{
+				Parent[Index] = Index;
+				Size[Index] = 1;
+			}
+		}
+
+		int32 Find(int32 Index)
+		{
+			while (Parent[Index] != Index)
+			{
+				Parent[Index] = Parent[Parent[Index]];
+				Index = Parent[Index];
+			}
+			return Index;
+		}
+
+		// Returns false if both were already in the same set
+		bool Union(int32 A, int32 B)
+		{
+			A = Find(A);
+			B = Find(B);
+			if (A == B)
+			{
+				return false;
+			}
+			if (Size[A] < Size[B])
+			{
+				Swap(A, B);
+			}
+			Parent[B] = A;
+			Size[A] += Size[B];
+			return true;
+		}
+	};
+}
+
+void FMinimumSpanningTree::GetUniqueEdges(TConstArrayView<FIntVector> Triangles, TArray<FIntPoint>& OutEdges)
+{
+	OutEdges.Reset(Triangles.Num() * 3);
+	for (const FIntVector& Tri : Triangles)
+	{
+		OutEdges.Add(FIntPoint(FMath::Min(Tri.X, Tri.Y), FMath::Max(Tri.X, Tri.Y)));
+		OutEdges.Add(FIntPoint(FMath::Min(Tri.Y, Tri.Z), FMath::Max(Tri.Y, Tri.Z)));
+		OutEdges.Add(FIntPoint(FMath::Min(Tri.Z, Tri.X), FMath::Max(Tri.Z, Tri.X)));
+	}
+
+	// Interior edges are shared by two triangles
+	Algo::Sort(OutEdges, [](const FIntPoint& A, const FIntPoint& B)
+	{
+		return A.X != B.X ? A.X < B.X : A.Y < B.Y;
+	});
+	OutEdges.SetNum(Algo::Unique(OutEdges));
+}
+
+void FMinimumSpanningTree::Build(TConstArrayView<FVector2f> Vertices, TConstArrayView<FIntPoint> Edges, TArray<FIntPoint>& OutTree)
+{
+	FDungeonArena Scratch;
+	Build(Vertices, Edges, OutTree, Scratch);
+}
+
+void FMinimumSpanningTree::Build(TConstArrayView<FVector2f> Vertices, TConstArrayView<FIntPoint> Edges, TArray<FIntPoint>& OutTree, FDungeonArena& Scratch)
+{
+	const FDungeonArena::FMark Mark(Scratch);
+	OutTree.Reset(FMath::Max(Vertices.Num() - 1, 0));
+
+	struct FWeightedEdge
+	{
+		float LengthSquared;
+		int32 EdgeIndex;
+	};
+
+	TArrayView<FWeightedEdge> SortedEdges = Scratch.AllocateArray<FWeightedEdge>(Edges.Num());
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); ++EdgeIndex)
+	{
+		const FIntPoint& Edge = Edges[EdgeIndex];
+		SortedEdges[EdgeIndex] = {FVector2f::DistSquared(Vertices[Edge.X], Vertices[Edge.Y]), EdgeIndex};
+	}
+	Algo::Sort(SortedEdges, [](const FWeightedEdge& A, const FWeightedEdge& B)
+	{
+		return A.LengthSquared != B.LengthSquared ? A.LengthSquared < B.LengthSquared : A.EdgeIndex < B.EdgeIndex;
+	});
+
+	// Kruskal: keep the shortest edge joining two different components
+	FUnionFind Components(Vertices.Num(), Scratch);
+	for (const FWeightedEdge& WeightedEdge : SortedEdges)
+	{
+		const FIntPoint& Edge = Edges[WeightedEdge.EdgeIndex];
+		if (Components.Union(Edge.X, Edge.Y))
+		{
+			OutTree.Add(Edge);
+			if (OutTree.Num() == Vertices.Num() - 1)
+			{
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,21 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FDungeonArena;
+
+// Minimum spanning tree over vertex indices (Kruskal's algorithm + union-find)
+struct DUNGEONPROCEDURAL_API FMinimumSpanningTree
+{
+	// Unique undirected edges of a set of triangles, each stored once with X < Y
+	static void GetUniqueEdges(TConstArrayView<FIntVector> Triangles, TArray<FIntPoint>& OutEdges);
+
+	// Minimum spanning forest of the graph in O(E log V)
+	// Edges of equal length are taken in (X, Y) order so the result is deterministic
+	static void Build(TConstArrayView<FVector2f> Vertices, TConstArrayView<FIntPoint> Edges, TArray<FIntPoint>& OutTree);
+
+	// Same, with the sort keys and the union-find taken from Scratch
+	static void Build(TConstArrayView<FVector2f> Vertices, TConstArrayView<FIntPoint> Edges, TArray<FIntPoint>& OutTree, FDungeonArena& Scratch);
+};
@@ -0,0 +1,609 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/ParallelDelaunay.h"
+
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "DungeonProcedural/DelaunayMesh.h"
+#include "DungeonProcedural/GeometryPredicates.h"
+
+#include <atomic>
+
+namespace
+{
+	// Fewer points per cell and the seams cost more than the cells
+	constexpr int32 MinPointsPerCell = 256;
+
+	// Rectangle owning the points of one cell, the outer sides follow the bounds of all points
+	struct FCellRegion
+	{
+		double MinX = 0;
+		double MaxX = 0;
+		double MinY = 0;
+		double MaxY = 0;
+	};
+
+	struct FCell
+	{
+		FCellRegion Region;
+		TArray<int32> Points;
+
+		// Local triangles already known to be final, global vertex indices
+		TArray<FIntVector> Triangles;
+
+		// Work of the local mesh, published once all cells are done
+		FDelaunayMesh::FCounters Counters;
+	};
+
+	// Circumcircle with its radius grown to cover the rounding error
+	// Returns false for nearly flat triangles, whose circle cannot be bounded reliably.
+	bool ComputeCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, FVector2D& OutCenter, double& OutRadius)
+	{
+		const FVector2D AB = B - A;
+		const FVector2D AC = C - A;
+		const double D = 2 * (AB.X * AC.Y - AB.Y * AC.X);
+		const double AB2 = AB.SizeSquared();
+		const double AC2 = AC.SizeSquared();
+		if (FMath::Abs(D) <= 1e-8 * (AB2 + AC2))
+		{
+			return false;
+		}
+
+		const FVector2D Offset((AC.Y * AB2 - AB.Y * AC2) / D, (AB.X * AC2 - AC.X * AB2) / D);
+		OutCenter = A + Offset;
+		OutRadius = Offset.Size();
+		OutRadius += 1e-6 * OutRadius + 1e-9 * (FMath::Abs(A.X) + FMath::Abs(A.Y));
+		return true;
+	}
+
+	// True if a neighbor of the mesh triangle has its opposite vertex exactly on the triangle circle
+	// Such cocircular points have several valid triangulations, the serial insertion order decides
+	// which one, so the parallel path cannot promise the same triangles. Vertices below FirstVertex are ignored.
+	bool HasCocircularNeighbor(const FDelaunayMesh& Mesh, int32 TriangleIndex, int32 FirstVertex)
+	{
+		const TArray<FDelaunayMesh::FMeshTriangle>& Triangles = Mesh.GetMeshTriangles();
+		const FDelaunayMesh::FMeshTriangle& Tri = Triangles[TriangleIndex];
+		for (int32 i = 0; i < 3; ++i)
+		{
+			if (Tri.N[i] == INDEX_NONE)
+			{
+				continue;
+			}
+
+			const FDelaunayMesh::FMeshTriangle& Neighbor = Triangles[Tri.N[i]];
+			for (int32 j = 0; j < 3; ++j)
+			{
+				const int32 Opposite = Neighbor.V[j];
+				if (Opposite == Tri.V[(i + 1) % 3] || Opposite == Tri.V[(i + 2) % 3])
+				{
+					continue;
+				}
+				if (Opposite >= FirstVertex
+					&& FGeometryPredicates::InCircle(Mesh.GetVertex(Tri.V[0]), Mesh.GetVertex(Tri.V[1]), Mesh.GetVertex(Tri.V[2]), Mesh.GetVertex(Opposite)) == 0)
+				{
+					return true;
+				}
+				break;
+			}
+		}
+		return false;
+	}
+
+	class FTriangulationMerger
+	{
+	public:
+		FTriangulationMerger(const TArray<FVector2D>& InVertices, int32 InNumPoints)
+			: Vertices(InVertices)
+			, NumPoints(InNumPoints)
+		{
+		}
+
+		// True if the local triangle of this cell is part of the full triangulation
+		// Its circle is inside the cell, so no point of another cell can be in it. The super-triangle
+		// is not part of any cell and is checked explicitly. Vertices are rotated to start at the
+		// smallest index so the seam merge evaluates the exact same floating point circle.
+		bool IsFinal(int32 I0, int32 I1, int32 I2, const FCellRegion& Region) const
+		{
+			if (I1 < I0 && I1 < I2)
+			{
+				Swap(I0, I1);
+				Swap(I1, I2);
+			}
+			else if (I2 < I0 && I2 < I1)
+			{
+				Swap(I0, I2);
+				Swap(I1, I2);
+			}
+
+			FVector2D Center;
+			double Radius;
+			if (!ComputeCircle(Vertices[I0], Vertices[I1], Vertices[I2], Center, Radius)
+				|| Center.X - Radius <= Region.MinX || Center.X + Radius >= Region.MaxX
+				|| Center.Y - Radius <= Region.MinY || Center.Y + Radius >= Region.MaxY)
+			{
+				return false;
+			}
+
+			for (int32 SuperVertex = NumPoints; SuperVertex < Vertices.Num(); ++SuperVertex)
+			{
+				if (FGeometryPredicates::InCircle(Vertices[I0], Vertices[I1], Vertices[I2], Vertices[SuperVertex]) >= 0)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		// Buckets the points left out of the seam triangulation
+		void BuildGrid(const TArray<bool>& IsBorder)
+		{
+			GridPoints.Reset();
+			Bounds = FBox2D(ForceInit);
+			for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+			{
+				if (!IsBorder[PointIndex])
+				{
+					GridPoints.Add(PointIndex);
+					Bounds += Vertices[PointIndex];
+				}
+			}
+			if (GridPoints.Num() == 0)
+			{
+				return;
+			}
+
+			// About two points per cell
+			GridSize = FMath::Clamp(FMath::CeilToInt32(FMath::Sqrt(GridPoints.Num() * 0.5)), 1, 4096);
+			const FVector2D Size = Bounds.GetSize();
+			CellScale = FVector2D(GridSize / FMath::Max(Size.X, UE_DOUBLE_SMALL_NUMBER), GridSize / FMath::Max(Size.Y, UE_DOUBLE_SMALL_NUMBER));
+
+			// Counting sort of the points by cell
+			CellStart.Init(0, GridSize * GridSize + 1);
+			TArray<int32> PointCell;
+			PointCell.SetNumUninitialized(GridPoints.Num());
+			for (int32 i = 0; i < GridPoints.Num(); ++i)
+			{
+				const FIntPoint Cell = ToCell(Vertices[GridPoints[i]]);
+				PointCell[i] = Cell.Y * GridSize + Cell.X;
+				++CellStart[PointCell[i] + 1];
+			}
+			for (int32 Cell = 0; Cell < GridSize * GridSize; ++Cell)
+			{
+				CellStart[Cell + 1] += CellStart[Cell];
+			}
+			CellPoints.SetNumUninitialized(GridPoints.Num());
+			TArray<int32> Cursor(CellStart.GetData(), GridSize * GridSize);
+			for (int32 i = 0; i < GridPoints.Num(); ++i)
+			{
+				CellPoints[Cursor[PointCell[i]]++] = GridPoints[i];
+			}
+		}
+
+		// True if no grid point is strictly inside the circumcircle of the counter-clockwise triangle
+		// bOutCocircular is set if a grid point lies exactly on the circle.
+		bool IsEmpty(int32 I0, int32 I1, int32 I2, bool& bOutCocircular) const
+		{
+			if (GridPoints.Num() == 0)
+			{
+				return true;
+			}
+
+			const FVector2D& A = Vertices[I0];
+			const FVector2D& B = Vertices[I1];
+			const FVector2D& C = Vertices[I2];
+			FVector2D Center;
+			double Radius;
+			if (!ComputeCircle(A, B, C, Center, Radius))
+			{
+				for (int32 PointIndex : GridPoints)
+				{
+					if (!TestPoint(A, B, C, PointIndex, bOutCocircular))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			// Only visit the cells of each row that the circle crosses
+			const FIntPoint MinCell = ToCell(Center - FVector2D(Radius));
+			const FIntPoint MaxCell = ToCell(Center + FVector2D(Radius));
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				const double RowMin = Bounds.Min.Y + Y / CellScale.Y;
+				const double RowMax = Bounds.Min.Y + (Y + 1) / CellScale.Y;
+				const double DY = Center.Y < RowMin ? RowMin - Center.Y : (Center.Y > RowMax ? Center.Y - RowMax : 0);
+				if (DY > Radius)
+				{
+					continue;
+				}
+				const double HalfWidth = FMath::Sqrt(Radius * Radius - DY * DY);
+				const int32 MinX = ToCell(FVector2D(Center.X - HalfWidth, Center.Y)).X;
+				const int32 MaxX = ToCell(FVector2D(Center.X + HalfWidth, Center.Y)).X;
+				for (int32 Slot = CellStart[Y * GridSize + MinX]; Slot < CellStart[Y * GridSize + MaxX + 1]; ++Slot)
+				{
+					if (!TestPoint(A, B, C, CellPoints[Slot], bOutCocircular))
+					{
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+	private:
+		bool TestPoint(const FVector2D& A, const FVector2D& B, const FVector2D& C, int32 PointIndex, bool& bOutCocircular) const
+		{
+			const double Side = FGeometryPredicates::InCircle(A, B, C, Vertices[PointIndex]);
+			bOutCocircular |= Side == 0;
+			return Side <= 0;
+		}
+
+		FIntPoint ToCell(const FVector2D& Point) const
+		{
+			const FVector2D Cell = (Point - Bounds.Min) * CellScale;
+			return FIntPoint(
+				FMath::Clamp(FMath::FloorToInt32(FMath::Clamp(Cell.X, -1.0, double(GridSize))), 0, GridSize - 1),
+				FMath::Clamp(FMath::FloorToInt32(FMath::Clamp(Cell.Y, -1.0, double(GridSize))), 0, GridSize - 1));
+		}
+
+		const TArray<FVector2D>& Vertices;
+		const int32 NumPoints;
+
+		FBox2D Bounds;
+		FVector2D CellScale = FVector2D::UnitVector;
+		int32 GridSize = 0;
+		TArray<int32> GridPoints;
+		TArray<int32> CellStart;
+		TArray<int32> CellPoints;
+	};
+
+	// Triangulates the points of one cell on its own, keeps the final triangles and flags the seam points
+	void TriangulateCell(const TArray<FVector2D>& Vertices, const FTriangulationMerger& Merger, FCell& Cell, TArray<bool>& IsBorder, std::atomic<bool>& bCocircular)
+	{
+		TArray<FVector2D> Points;
+		Points.Reserve(Cell.Points.Num());
+		for (int32 PointIndex : Cell.Points)
+		{
+			Points.Add(Vertices[PointIndex]);
+		}
+
+		// Built around the whole region rather than the points, so no circle inside the region
+		// can contain a super-triangle vertex and every final triangle shows up in the local mesh
+		const FVector2D RegionCorners[] = {FVector2D(Cell.Region.MinX, Cell.Region.MinY), FVector2D(Cell.Region.MaxX, Cell.Region.MaxY)};
+		FVector2D SuperA, SuperB, SuperC;
+		FDelaunayMesh::ComputeSuperTriangle(RegionCorners, SuperA, SuperB, SuperC);
+		TArray<int32> InsertionOrder;
+		FDelaunayMesh::SortForInsertion(Points, InsertionOrder);
+
+		FDelaunayMesh Mesh;
+		Mesh.Init(SuperA, SuperB, SuperC, Points.Num());
+		TArray<int32> PointByVertex;
+		PointByVertex.Init(INDEX_NONE, Points.Num() + FDelaunayMesh::NumSuperVertices);
+		for (int32 LocalIndex : InsertionOrder)
+		{
+			const int32 Vertex = Mesh.Insert(Points[LocalIndex]);
+			if (Vertex != INDEX_NONE)
+			{
+				PointByVertex[Vertex] = Cell.Points[LocalIndex];
+			}
+		}
+
+		Cell.Counters = Mesh.GetCounters();
+		Cell.Triangles.Reset(2 * Points.Num());
+		const TArray<FDelaunayMesh::FMeshTriangle>& MeshTriangles = Mesh.GetMeshTriangles();
+		for (int32 TriangleIndex = 0; TriangleIndex < MeshTriangles.Num(); ++TriangleIndex)
+		{
+			const FDelaunayMesh::FMeshTriangle& Tri = MeshTriangles[TriangleIndex];
+			if (!Tri.IsAlive())
+			{
+				continue;
+			}
+
+			const int32 I0 = PointByVertex[Tri.V[0]];
+			const int32 I1 = PointByVertex[Tri.V[1]];
+			const int32 I2 = PointByVertex[Tri.V[2]];
+			if (I0 != INDEX_NONE && I1 != INDEX_NONE && I2 != INDEX_NONE && Merger.IsFinal(I0, I1, I2, Cell.Region))
+			{
+				if (HasCocircularNeighbor(Mesh, TriangleIndex, FDelaunayMesh::NumSuperVertices))
+				{
+					bCocircular = true;
+				}
+				Cell.Triangles.Add(FIntVector(I0, I1, I2));
+				continue;
+			}
+
+			for (const int32 PointIndex : {I0, I1, I2})
+			{
+				if (PointIndex != INDEX_NONE)
+				{
+					IsBorder[PointIndex] = true;
+				}
+			}
+		}
+	}
+}
+
+bool FParallelDelaunay::Triangulate(TConstArrayView<FVector2D> Points, const FVector2D& SuperA, const FVector2D& SuperB, const FVector2D& SuperC,
+	TArray<FIntVector>& OutTriangles, int32 NumPartitions)
+{
+	OutTriangles.Reset();
+	if (Points.Num() == 0)
+	{
+		return true;
+	}
+
+	TArray<int32> ByPosition;
+	ByPosition.SetNumUninitialized(Points.Num());
+	for (int32 i = 0; i < Points.Num(); ++i)
+	{
+		ByPosition[i] = i;
+	}
+	Algo::Sort(ByPosition, [&Points](int32 L, int32 R)
+	{
+		if (Points[L].X != Points[R].X) return Points[L].X < Points[R].X;
+		return Points[L].Y < Points[R].Y;
+	});
+
+	// Duplicated points collapse on the one inserted first along the Hilbert curve, like FDelaunayMesh::Insert
+	// The insertion order is only computed when some point is actually duplicated.
+	TArray<int32> Rank;
+	int32 Head = 0;
+	for (int32 i = 1; i < ByPosition.Num(); ++i)
+	{
+		if (Points[ByPosition[i]] != Points[ByPosition[Head]])
+		{
+			Head = i;
+			continue;
+		}
+
+		if (Rank.Num() == 0)
+		{
+			TArray<int32> InsertionOrder;
+			FDelaunayMesh::SortForInsertion(Points, InsertionOrder);
+			Rank.SetNumUninitialized(Points.Num());
+			for (int32 Order = 0; Order < InsertionOrder.Num(); ++Order)
+			{
+				Rank[InsertionOrder[Order]] = Order;
+			}
+		}
+
+		// Keep the first inserted point at the head of its group
+		if (Rank[ByPosition[i]] < Rank[ByPosition[Head]])
+		{
+			Swap(ByPosition[i], ByPosition[Head]);
+		}
+	}
+
+	// Unique points, then the super-triangle
+	TArray<FVector2D> Vertices;
+	TArray<int32> SourceIndex;
+	Vertices.Reserve(Points.Num() + FDelaunayMesh::NumSuperVertices);
+	SourceIndex.Reserve(Points.Num());
+	for (int32 i = 0; i < ByPosition.Num(); ++i)
+	{
+		if (i == 0 || Points[ByPosition[i]] != Points[ByPosition[i - 1]])
+		{
+			Vertices.Add(Points[ByPosition[i]]);
+			SourceIndex.Add(ByPosition[i]);
+		}
+	}
+	const int32 NumPoints = Vertices.Num();
+	const FBox2D Bounds(Vertices.GetData(), NumPoints);
+	Vertices.Add(SuperA);
+	Vertices.Add(SuperB);
+	Vertices.Add(SuperC);
+
+	// Columns of equal point counts split into rows of equal point counts
+	// Unique points are already sorted by X.
+	if (NumPartitions <= 0)
+	{
+		NumPartitions = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	}
+	NumPartitions = FMath::Clamp(NumPartitions, 1, FMath::Max(NumPoints / MinPointsPerCell, 1));
+	const int32 NumColumns = FMath::Max(FMath::FloorToInt32(FMath::Sqrt(double(NumPartitions))), 1);
+	const int32 NumRows = FMath::DivideAndRoundUp(NumPartitions, NumColumns);
+
+	TArray<FCell> Cells;
+	Cells.SetNum(NumColumns * NumRows);
+	for (int32 Column = 0; Column < NumColumns; ++Column)
+	{
+		const int32 Begin = int64(Column) * NumPoints / NumColumns;
+		const int32 End = int64(Column + 1) * NumPoints / NumColumns;
+		const double MinX = Column > 0 ? Vertices[Begin].X : Bounds.Min.X;
+		const double MaxX = Column < NumColumns - 1 ? Vertices[End].X : Bounds.Max.X;
+
+		TArray<int32> ColumnPoints;
+		ColumnPoints.Reserve(End - Begin);
+		for (int32 PointIndex = Begin; PointIndex < End; ++PointIndex)
+		{
+			ColumnPoints.Add(PointIndex);
+		}
+		Algo::Sort(ColumnPoints, [&Vertices](int32 L, int32 R) { return Vertices[L].Y < Vertices[R].Y; });
+
+		for (int32 Row = 0; Row < NumRows; ++Row)
+		{
+			const int32 RowBegin = int64(Row) * ColumnPoints.Num() / NumRows;
+			const int32 RowEnd = int64(Row + 1) * ColumnPoints.Num() / NumRows;
+			FCell& Cell = Cells[Column * NumRows + Row];
+			Cell.Region.MinX = MinX;
+			Cell.Region.MaxX = MaxX;
+			Cell.Region.MinY = Row > 0 ? Vertices[ColumnPoints[RowBegin]].Y : Bounds.Min.Y;
+			Cell.Region.MaxY = Row < NumRows - 1 ? Vertices[ColumnPoints[RowEnd]].Y : Bounds.Max.Y;
+			Cell.Points = TArray<int32>(ColumnPoints.GetData() + RowBegin, RowEnd - RowBegin);
+		}
+	}
+
+	FTriangulationMerger Merger(Vertices, NumPoints);
+	TArray<bool> IsBorder;
+	IsBorder.Init(false, NumPoints);
+	TArray<int32> CellByPoint;
+	CellByPoint.SetNumUninitialized(NumPoints);
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+	{
+		for (int32 PointIndex : Cells[CellIndex].Points)
+		{
+			CellByPoint[PointIndex] = CellIndex;
+		}
+	}
+
+	// Cells own disjoint points, so each one only writes its own border flags
+	std::atomic<bool> bCocircular = false;
+	ParallelFor(Cells.Num(), [&](int32 CellIndex)
+	{
+		TriangulateCell(Vertices, Merger, Cells[CellIndex], IsBorder, bCocircular);
+	});
+
+	// Seam triangulation of the border points inside the same super-triangle as the serial path
+	// Every missing triangle has its three vertices there, so it is one of these.
+	TArray<int32> SeamPoints;
+	TArray<FVector2D> SeamVertices;
+	for (int32 PointIndex = 0; PointIndex < NumPoints; ++PointIndex)
+	{
+		if (IsBorder[PointIndex])
+		{
+			SeamPoints.Add(PointIndex);
+			SeamVertices.Add(Vertices[PointIndex]);
+		}
+	}
+	TArray<int32> SeamOrder;
+	FDelaunayMesh::SortForInsertion(SeamVertices, SeamOrder);
+
+	FDelaunayMesh SeamMesh;
+	SeamMesh.Init(SuperA, SuperB, SuperC, SeamVertices.Num());
+	TArray<int32> PointByVertex;
+	PointByVertex.SetNumUninitialized(SeamVertices.Num() + FDelaunayMesh::NumSuperVertices);
+	for (int32 SuperVertex = 0; SuperVertex < FDelaunayMesh::NumSuperVertices; ++SuperVertex)
+	{
+		// Init may swap B and C to keep the super-triangle counter-clockwise
+		PointByVertex[SuperVertex] = NumPoints + (SeamMesh.GetVertex(SuperVertex) == SuperA ? 0 : SeamMesh.GetVertex(SuperVertex) == SuperB ? 1 : 2);
+	}
+	for (int32 SeamIndex : SeamOrder)
+	{
+		const int32 Vertex = SeamMesh.Insert(SeamVertices[SeamIndex]);
+		if (Vertex == INDEX_NONE)
+		{
+			return false;
+		}
+		PointByVertex[Vertex] = SeamPoints[SeamIndex];
+	}
+
+	// Seam triangles already produced by a cell are skipped, the others must also be
+	// empty of the points that were left out of the seam triangulation
+	TArray<FIntVector> SeamTriangles;
+	TArray<int32> SeamMeshTriangles;
+	const TArray<FDelaunayMesh::FMeshTriangle>& MeshTriangles = SeamMesh.GetMeshTriangles();
+	for (int32 TriangleIndex = 0; TriangleIndex < MeshTriangles.Num(); ++TriangleIndex)
+	{
+		const FDelaunayMesh::FMeshTriangle& Tri = MeshTriangles[TriangleIndex];
+		if (!Tri.IsAlive())
+		{
+			continue;
+		}
+
+		const int32 I0 = PointByVertex[Tri.V[0]];
+		const int32 I1 = PointByVertex[Tri.V[1]];
+		const int32 I2 = PointByVertex[Tri.V[2]];
+		const bool bSameCell = I0 < NumPoints && I1 < NumPoints && I2 < NumPoints
+			&& CellByPoint[I0] == CellByPoint[I1] && CellByPoint[I0] == CellByPoint[I2];
+		if (!bSameCell || !Merger.IsFinal(I0, I1, I2, Cells[CellByPoint[I0]].Region))
+		{
+			SeamTriangles.Add(FIntVector(I0, I1, I2));
+			SeamMeshTriangles.Add(TriangleIndex);
+		}
+	}
+
+	Merger.BuildGrid(IsBorder);
+	TArray<bool> IsKept;
+	IsKept.SetNumUninitialized(SeamTriangles.Num());
+	ParallelFor(SeamTriangles.Num(), [&](int32 TriangleIndex)
+	{
+		const FIntVector& Tri = SeamTriangles[TriangleIndex];
+		bool bOnCircle = false;
+		IsKept[TriangleIndex] = Merger.IsEmpty(Tri.X, Tri.Y, Tri.Z, bOnCircle);
+		if (IsKept[TriangleIndex] && (bOnCircle || HasCocircularNeighbor(SeamMesh, SeamMeshTriangles[TriangleIndex], 0)))
+		{
+			bCocircular = true;
+		}
+	});
+
+	if (bCocircular)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("Parallel triangulation found cocircular points, the serial path must decide their triangles"));
+		return false;
+	}
+
+	// A full triangulation of N points inside the super-triangle has 2N + 1 triangles,
+	// anything else means the seams were not merged correctly
+	int32 NumTriangles = 0;
+	for (const FCell& Cell : Cells)
+	{
+		NumTriangles += Cell.Triangles.Num();
+	}
+	for (bool bKept : IsKept)
+	{
+		NumTriangles += bKept ? 1 : 0;
+	}
+	if (NumTriangles != 2 * NumPoints + 1)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Parallel triangulation found %d triangles instead of %d, seams could not be merged"), NumTriangles, 2 * NumPoints + 1);
+		return false;
+	}
+
+	// Only published on success, a fallback publishes the serial mesh work instead
+	FDelaunayMesh::FCounters Counters = SeamMesh.GetCounters();
+	for (const FCell& Cell : Cells)
+	{
+		Counters += Cell.Counters;
+	}
+	FDelaunayMesh::PublishCounters(Counters);
+
+	// Triangles connected to the super-triangle are dropped, like FDelaunayMesh::GetTriangles
+	OutTriangles.Reserve(2 * NumPoints);
+	auto AddTriangle = [&](const FIntVector& Tri)
+	{
+		if (Tri.X < NumPoints && Tri.Y < NumPoints && Tri.Z < NumPoints)
+		{
+			OutTriangles.Add(FIntVector(SourceIndex[Tri.X], SourceIndex[Tri.Y], SourceIndex[Tri.Z]));
+		}
+	};
+	for (const FCell& Cell : Cells)
+	{
+		for (const FIntVector& Tri : Cell.Triangles)
+		{
+			AddTriangle(Tri);
+		}
+	}
+	for (int32 TriangleIndex = 0; TriangleIndex < SeamTriangles.Num(); ++TriangleIndex)
+	{
+		if (IsKept[TriangleIndex])
+		{
+			AddTriangle(SeamTriangles[TriangleIndex]);
+		}
+	}
+	return true;
+}
+
+void FParallelDelaunay::SortTriangles(TArray<FIntVector>& Triangles)
+{
+	for (FIntVector& Tri : Triangles)
+	{
+		if (Tri.Y < Tri.X && Tri.Y < Tri.Z)
+		{
+			Tri = FIntVector(Tri.Y, Tri.Z, Tri.X);
+		}
+		else if (Tri.Z < Tri.X && Tri.Z < Tri.Y)
+		{
+			Tri = FIntVector(Tri.Z, Tri.X, Tri.Y);
+		}
+	}
+
+	Algo::Sort(Triangles, [](const FIntVector& L, const FIntVector& R)
+	{
+		if (L.X != R.X) return L.X < R.X;
+		if (L.Y != R.Y) return L.Y < R.Y;
+		return L.Z < R.Z;
+	});
+}
@@ -0,0 +1,28 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Divide-and-conquer Delaunay triangulation spread over several cores
+// Points are split into rectangular cells triangulated in parallel. A local triangle whose
+// circumcircle stays inside its cell is final. The vertices of every other triangle are
+// triangulated again, and those triangles are kept only if no point lies in their circumcircle.
+// The result is checked against the triangle count of a full triangulation before being returned.
+class DUNGEONPROCEDURAL_API FParallelDelaunay
+{
+public:
+	// Below this many points the serial FDelaunayMesh is faster
+	static constexpr int32 MinParallelPoints = 20000;
+
+	// Same triangles as inserting Points in Hilbert order into an FDelaunayMesh built on SuperA, SuperB, SuperC
+	// and calling GetTriangles, for points in general position. Indices refer to Points, duplicated points
+	// map to the first one inserted. NumPartitions <= 0 uses one cell per worker thread.
+	// Returns false if the seams could not be merged (cocircular points), OutTriangles is then empty.
+	static bool Triangulate(TConstArrayView<FVector2D> Points, const FVector2D& SuperA, const FVector2D& SuperB, const FVector2D& SuperC,
+		TArray<FIntVector>& OutTriangles, int32 NumPartitions = 0);
+
+	// Rotates each triangle to start at its smallest index, then sorts the list
+	// Gives the serial and the parallel paths identical arrays.
+	static void SortTriangles(TArray<FIntVector>& Triangles);
+};
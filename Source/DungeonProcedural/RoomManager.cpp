@@ -4,55 +4,563 @@
 #include "DungeonProcedural/RoomManager.h"
 
 #include "Components/BoxComponent.h"
+#include "Async/Async.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "DungeonProcedural/DelaunayMesh.h"
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "DungeonProcedural/DungeonLayoutFile.h"
+#include "DungeonProcedural/DungeonStats.h"
+#include "DungeonProcedural/MinimumSpanningTree.h"
+#include "DungeonProcedural/ParallelDelaunay.h"
+#include "DungeonProcedural/SegmentBVH.h"
 #include "DungeonProcedural/Triangle.h"
+#include "HAL/PlatformTime.h"
 #include "Kismet/GameplayStatics.h"
 #include "Math/Box.h"
 #include "Math/Vector.h"
 #include "Math/UnrealMathUtility.h"
+#include "Tasks/Task.h"
 
-void URoomManager::GenerateMap(int NbRoom, TArray<FRoomType> RoomTypes)
+namespace
 {
-	ClearAll();	
-	// Calculate total probability for weighted random selection
-	float MaxProba = 0;
-	for (FRoomType& RoomType : RoomTypes)
+	// Steps of the time-sliced generation after the generator stages
+	constexpr int32 SpawnRoomsStep = int32(EDungeonStage::Num);
+	constexpr int32 SpawnCorridorsStep = SpawnRoomsStep + 1;
+	constexpr int32 NumTimeSlicedSteps = SpawnCorridorsStep + 1;
+
+	const TCHAR* TimeSlicedStepNames[NumTimeSlicedSteps] =
+	{
+		TEXT("SampleRooms"),
+		TEXT("ResolveOverlaps"),
+		TEXT("Triangulate"),
+		TEXT("CreatePath"),
+		TEXT("EvolvePath"),
+		TEXT("ClearSecondaryRooms"),
+		TEXT("SpawnRooms"),
+		TEXT("SpawnCorridors"),
+	};
+
+	// Rough share of the total time of each step, measured with the generation benchmark
+	constexpr float TimeSlicedStepWeights[NumTimeSlicedSteps] = { 0.02f, 0.25f, 0.2f, 0.05f, 0.02f, 0.06f, 0.3f, 0.1f };
+}
+
+void URoomManager::GenerateMap(int NbRoom, const TArray<FRoomType>& RoomTypes, int32 Seed)
+{
+	ClearAll();
+	Seed = ResolveSeed(Seed);
+
+	// Sample and separate rooms on plain data, then spawn each room once at its final place
+	const FDungeonGenerationSettings Settings = MakeGenerationSettings(NbRoom, RoomTypes, nullptr, nullptr, Seed);
+	const uint64 CacheKey = FDungeonLayoutCache::MakeKey(Settings, EDungeonStage::ResolveOverlaps);
+	if (!bUseLayoutCache || !LayoutCache->Find(CacheKey, Layout))
 	{
-		MaxProba += RoomType.Probability;
+		FDungeonGenerator Generator(Settings);
+		Generator.SampleRooms();
+		Generator.ResolveRoomOverlaps();
+
+		Layout = MoveTemp(Generator.GetLayout());
+		if (bUseLayoutCache)
+		{
+			LayoutCache->Add(CacheKey, Layout, Seed);
+		}
 	}
+	SpawnRooms(Layout, RoomTypes);
+}
 
-	
-	// Spawn rooms using weighted random selection based on probability
-	for (int i = 0; i < NbRoom; ++i)
+void URoomManager::GenerateDungeon(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP,
+	TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, int32 Seed)
+{
+	ClearAll();
+	Seed = ResolveSeed(Seed);
+
+	FDungeonGenerationSettings Settings = MakeGenerationSettings(NbRoom, RoomTypes, RoomP, RoomS, Seed);
+	Settings.bParallelTriangulation = bParallelTriangulation;
+	Settings.bRouteCorridors = bRouteCorridors;
+
+	const uint64 CacheKey = FDungeonLayoutCache::MakeKey(Settings);
+	FDungeonLayout CachedLayout;
+	if (bUseLayoutCache && LayoutCache->Find(CacheKey, CachedLayout))
 	{
-		float CurrentProba = FMath::FRandRange(0,MaxProba);
-		
-		// Find room type using cumulative probability distribution
-		float currentMaxProbability = 0;
-		FRoomType* RoomType = RoomTypes.FindByPredicate([CurrentProba, &currentMaxProbability](const FRoomType& Room){
-			currentMaxProbability += Room.Probability;
-			return CurrentProba < currentMaxProbability;
+		CommitLayout(MoveTemp(CachedLayout), RoomTypes, CorridorBP);
+		return;
+	}
+
+	FDungeonGenerator Generator(Settings);
+	Generator.Run();
+	if (bUseLayoutCache)
+	{
+		LayoutCache->Add(CacheKey, Generator.GetLayout(), Seed);
+	}
+	CommitLayout(MoveTemp(Generator.GetLayout()), RoomTypes, CorridorBP);
+}
+
+int32 URoomManager::GenerateDungeonAsync(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP,
+	TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, int32 Seed)
+{
+	ClearAll();
+	Seed = ResolveSeed(Seed);
+
+	const TSharedRef<FDungeonAsyncJob> Job = MakeShared<FDungeonAsyncJob>();
+	Job->RunId = ++LastAsyncRunId;
+	AsyncJob = Job;
+
+	// Class default objects are read here, the worker only sees plain data
+	FDungeonGenerationSettings Settings = MakeGenerationSettings(NbRoom, RoomTypes, RoomP, RoomS, Seed);
+	Settings.bParallelTriangulation = bParallelTriangulation;
+	Settings.bRouteCorridors = bRouteCorridors;
+	TWeakObjectPtr<URoomManager> WeakThis(this);
+
+	// A cached layout is still committed from the task queue, the caller gets the RunId first
+	const uint64 CacheKey = FDungeonLayoutCache::MakeKey(Settings);
+	FDungeonLayout CachedLayout;
+	if (bUseLayoutCache && LayoutCache->Find(CacheKey, CachedLayout))
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, Layout = MoveTemp(CachedLayout), RoomTypes, CorridorBP]() mutable
+		{
+			if (URoomManager* RoomManager = WeakThis.Get())
+			{
+				RoomManager->CommitAsyncLayout(Job, MoveTemp(Layout), RoomTypes, CorridorBP);
+			}
 		});
+		return Job->RunId;
+	}
 
-		if (RoomType != nullptr){
-			AActor* SpawnedActorRaw = GetWorld()->SpawnActor(RoomType->TypeOfRoomToSpawn);
+	TSharedPtr<FDungeonLayoutCache, ESPMode::ThreadSafe> Cache;
+	if (bUseLayoutCache)
+	{
+		Cache = LayoutCache;
+	}
+
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Job, Settings = MoveTemp(Settings), RoomTypes, CorridorBP, Cache, CacheKey]()
+	{
+		FDungeonGenerator Generator(Settings);
+		const bool bCompleted = Generator.Run([&WeakThis, &Job](EDungeonStage Stage)
+		{
+			if (Job->bCancelled)
+			{
+				return false;
+			}
+
+			const float Progress = float(Stage) / float(EDungeonStage::Num);
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, Progress]()
+			{
+				URoomManager* RoomManager = WeakThis.Get();
+				if (RoomManager && RoomManager->AsyncJob == Job)
+				{
+					RoomManager->OnGenerationProgress.Broadcast(Job->RunId, Progress);
+				}
+			});
+			return true;
+		});
+
+		if (!bCompleted)
+		{
+			return;
+		}
 
-			// Apply random scaling within defined size range
-			FVector RandomScale;
-			RandomScale.X = FMath::FRandRange(RoomType->SizeMin, RoomType->SizeMax);
-			RandomScale.Y = FMath::FRandRange(RoomType->SizeMin, RoomType->SizeMax);
-			RandomScale.Z = 1;
-			SpawnedActorRaw->SetActorScale3D(RandomScale);
+		// Cached before the commit, so the layout is kept even if the job gets cancelled meanwhile
+		if (Cache)
+		{
+			Cache->Add(CacheKey, Generator.GetLayout(), Settings.Seed);
+		}
 
-			
-			// Add to spawned actors list if it's a valid room
-			if (SpawnedActorRaw->IsA(ARoomParent::StaticClass()))
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Job, Layout = MoveTemp(Generator.GetLayout()), RoomTypes, CorridorBP]() mutable
+		{
+			if (URoomManager* RoomManager = WeakThis.Get())
 			{
-				SpawnedActors.Add(Cast<ARoomParent>(SpawnedActorRaw));
+				RoomManager->CommitAsyncLayout(Job, MoveTemp(Layout), RoomTypes, CorridorBP);
 			}
+		});
+	});
+
+	return Job->RunId;
+}
+
+void URoomManager::CommitAsyncLayout(const TSharedRef<FDungeonAsyncJob>& Job, FDungeonLayout&& InLayout, const TArray<FRoomType>& RoomTypes,
+	TSubclassOf<AActor> CorridorBP)
+{
+	// Spawn unless ClearAll or a newer generation replaced the job meanwhile
+	if (AsyncJob != Job)
+	{
+		return;
+	}
+
+	AsyncJob.Reset();
+	CommitLayout(MoveTemp(InLayout), RoomTypes, CorridorBP);
+	OnGenerationProgress.Broadcast(Job->RunId, 1.f);
+	OnGenerationFinished.Broadcast(Job->RunId, true);
+}
+
+void URoomManager::CancelAsyncGeneration()
+{
+	if (!AsyncJob)
+	{
+		return;
+	}
+
+	// The worker stops before its next stage and its result is dropped
+	AsyncJob->bCancelled = true;
+	const int32 RunId = AsyncJob->RunId;
+	AsyncJob.Reset();
+	OnGenerationFinished.Broadcast(RunId, false);
+}
+
+bool URoomManager::IsGeneratingAsync() const
+{
+	return AsyncJob.IsValid();
+}
+
+int32 URoomManager::StartTimeSlicedGeneration(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP,
+	TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, float BudgetMs, int32 Seed)
+{
+	if (bAutoDemo)
+	{
+		StopAutoDemo();
+	}
+	ClearAll();
+	Seed = ResolveSeed(Seed);
+
+	// The parallel triangulation would block the frame, the sliced one inserts a few points per frame
+	FDungeonGenerationSettings Settings = MakeGenerationSettings(NbRoom, RoomTypes, RoomP, RoomS, Seed);
+	Settings.bParallelTriangulation = false;
+	Settings.bRouteCorridors = bRouteCorridors;
+	SlicedGenerator = MakeUnique<FDungeonGenerator>(Settings);
+	SlicedCacheKey = FDungeonLayoutCache::MakeKey(Settings);
+	SlicedRoomTypes = RoomTypes;
+	SlicedCorridorBP = CorridorBP;
+	SlicedRunId = ++LastAsyncRunId;
+	TimeSliceBudgetMs = BudgetMs;
+
+	// Reuse the step-by-step state: stage in CurrentStep, cursor in CurrentPointIndex
+	CurrentStep = 0;
+	CurrentPointIndex = 0;
+
+	// A cached layout only needs the spawn steps
+	if (bUseLayoutCache && LayoutCache->Find(SlicedCacheKey, Layout))
+	{
+		UpdateDebugArrays();
+		CurrentStep = SpawnRoomsStep;
+	}
+
+	// First slice next frame, so the caller gets the RunId before any event
+	TimeSliceTimer = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &URoomManager::TimeSliceTick);
+	return SlicedRunId;
+}
+
+void URoomManager::CancelTimeSlicedGeneration()
+{
+	if (!SlicedGenerator)
+	{
+		return;
+	}
+
+	GetWorld()->GetTimerManager().ClearTimer(TimeSliceTimer);
+	SlicedGenerator.Reset();
+	SlicedRoomTypes.Empty();
+	CurrentStep = 0;
+	CurrentPointIndex = 0;
+	OnGenerationFinished.Broadcast(SlicedRunId, false);
+}
+
+bool URoomManager::IsGeneratingTimeSliced() const
+{
+	return SlicedGenerator.IsValid();
+}
+
+FString URoomManager::GetTimeSlicedStage() const
+{
+	return SlicedGenerator && CurrentStep < NumTimeSlicedSteps ? FString(TimeSlicedStepNames[CurrentStep]) : FString();
+}
+
+float URoomManager::GetTimeSlicedProgress() const
+{
+	if (!SlicedGenerator)
+	{
+		return 0.f;
+	}
+
+	float Progress = 0.f;
+	for (int32 Step = 0; Step < FMath::Min(CurrentStep, NumTimeSlicedSteps); ++Step)
+	{
+		Progress += TimeSlicedStepWeights[Step];
+	}
+
+	float StepProgress = 0.f;
+	if (CurrentStep < SpawnRoomsStep)
+	{
+		StepProgress = SlicedGenerator->GetStageProgress(EDungeonStage(CurrentStep), CurrentPointIndex);
+	}
+	else if (CurrentStep == SpawnRoomsStep)
+	{
+		StepProgress = float(CurrentPointIndex) / float(FMath::Max(Layout.NumRooms(), 1));
+	}
+	else if (CurrentStep == SpawnCorridorsStep)
+	{
+		StepProgress = float(CurrentPointIndex) / float(FMath::Max(CorridorsToSpawn.Num(), 1));
+	}
+
+	if (CurrentStep < NumTimeSlicedSteps)
+	{
+		Progress += TimeSlicedStepWeights[CurrentStep] * FMath::Min(StepProgress, 1.f);
+	}
+	return FMath::Min(Progress, 1.f);
+}
+
+void URoomManager::TimeSliceTick()
+{
+	if (!SlicedGenerator)
+	{
+		return;
+	}
+
+	// Short stages share a frame, a long one stops as soon as the budget is spent
+	const double EndTime = FPlatformTime::Seconds() + FMath::Max(TimeSliceBudgetMs, 0.f) / 1000.0;
+	do
+	{
+		bool bStepDone = false;
+		if (CurrentStep < SpawnRoomsStep)
+		{
+			bStepDone = SlicedGenerator->RunStageSliced(EDungeonStage(CurrentStep), CurrentPointIndex, EndTime);
+		}
+		else
+		{
+			bStepDone = RunSpawnSliced(CurrentStep, EndTime);
+		}
+
+		if (bStepDone)
+		{
+			++CurrentStep;
+			CurrentPointIndex = 0;
+
+			// Headless part done, the debug arrays are filled before spawning like in CommitLayout
+			if (CurrentStep == SpawnRoomsStep)
+			{
+				Layout = MoveTemp(SlicedGenerator->GetLayout());
+				if (bUseLayoutCache)
+				{
+					LayoutCache->Add(SlicedCacheKey, Layout, LastSeed);
+				}
+				UpdateDebugArrays();
+			}
+		}
+	}
+	while (CurrentStep < NumTimeSlicedSteps && FPlatformTime::Seconds() < EndTime);
+
+	if (CurrentStep < NumTimeSlicedSteps)
+	{
+		TimeSliceTimer = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &URoomManager::TimeSliceTick);
+		OnGenerationProgress.Broadcast(SlicedRunId, GetTimeSlicedProgress());
+		return;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Dungeon generated over several frames (seed %d): %d rooms, %d triangles, %d corridor segments."),
+		LastSeed, Layout.NumRooms(), Layout.Triangles.Num(), Layout.CorridorSegments.Num());
+
+	SlicedGenerator.Reset();
+	SlicedRoomTypes.Empty();
+	CurrentStep = 0;
+	CurrentPointIndex = 0;
+	OnGenerationProgress.Broadcast(SlicedRunId, 1.f);
+	OnGenerationFinished.Broadcast(SlicedRunId, true);
+}
+
+bool URoomManager::RunSpawnSliced(int32 Step, double EndTime)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(DungeonRunSpawnSliced);
+
+	// Instanced corridors are a single batched add, not worth splitting across frames
+	if (Step != SpawnRoomsStep && bInstancedCorridors)
+	{
+		SpawnInstancedConnectionModules(InstancedCorridorMesh, InstancedCorridorMaterial, InstancedCorridorMeshLength);
+		return true;
+	}
+
+	if (Step != SpawnRoomsStep && CurrentPointIndex == 0)
+	{
+		BuildCorridorsToSpawn();
+	}
+
+	const int32 NumUnits = Step == SpawnRoomsStep ? Layout.NumRooms() : (SlicedCorridorBP ? CorridorsToSpawn.Num() : 0);
+	while (CurrentPointIndex < NumUnits)
+	{
+		if (Step == SpawnRoomsStep)
+		{
+			SpawnRoom(Layout, SlicedRoomTypes, CurrentPointIndex++);
+		}
+		else
+		{
+			SpawnCorridor(CorridorsToSpawn[CurrentPointIndex++], SlicedCorridorBP);
+		}
+
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+	return CurrentPointIndex >= NumUnits;
+}
+
+void URoomManager::CommitLayout(FDungeonLayout&& InLayout, const TArray<FRoomType>& RoomTypes, TSubclassOf<AActor> CorridorBP)
+{
+	Layout = MoveTemp(InLayout);
+
+	// Materialize the final layout only
+	SpawnRooms(Layout, RoomTypes);
+	CommitPaths(CorridorBP);
+}
+
+void URoomManager::CommitPaths(TSubclassOf<AActor> CorridorBP)
+{
+	UpdateDebugArrays();
+
+	if (bInstancedCorridors)
+	{
+		SpawnInstancedConnectionModules(InstancedCorridorMesh, InstancedCorridorMaterial, InstancedCorridorMeshLength);
+	}
+	else if (CorridorBP)
+	{
+		SpawnConnectionModules(CorridorBP);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("Dungeon generated (seed %d): %d rooms, %d triangles, %d corridor segments."),
+		LastSeed, Layout.NumRooms(), Layout.Triangles.Num(), Layout.CorridorSegments.Num());
+}
+
+void URoomManager::UpdateDebugArrays()
+{
+	// Every committed layout goes through here, whatever path produced it
+	OccupancyGrid.Build(Layout, OccupancyCellSize > 0 ? OccupancyCellSize : FDungeonOccupancyGrid::ChooseCellSize(Layout.RoomExtents));
+
+	Layout.ToTriangles(AllTriangles);
+	Layout.ToPathEdges(FirstPath);
+	Layout.ToCorridorEdges(EvolvedPath);
+	TriangulationDone = true;
+
+	// Only kept in sync once something was drawn, headless generations do not build any line
+	if (IsValid(DebugDraw))
+	{
+		RefreshDebugLayer(EDungeonDebugLayer::Triangles);
+		RefreshDebugLayer(EDungeonDebugLayer::Path);
+		RefreshDebugLayer(EDungeonDebugLayer::Corridors);
+	}
+}
+
+void URoomManager::SetLayoutCacheDirectory(const FString& Directory)
+{
+	LayoutCache->SetDirectory(Directory);
+}
+
+void URoomManager::EmptyLayoutCache()
+{
+	LayoutCache->Empty();
+}
+
+FDungeonLayoutCacheStats URoomManager::GetLayoutCacheStats() const
+{
+	return LayoutCache->GetStats();
+}
+
+bool URoomManager::SaveLayout(const FString& Filename) const
+{
+	return FDungeonLayoutFile::Save(Layout, LastSeed, Filename);
+}
+
+bool URoomManager::LoadLayout(const FString& Filename, const TArray<FRoomType>& RoomTypes, TSubclassOf<AActor> CorridorBP)
+{
+	ClearAll();
+
+	FDungeonLayoutFile File;
+	if (!File.Open(Filename))
+	{
+		return false;
+	}
+	LastSeed = File.GetSeed();
+
+	// Rooms come straight from the mapping, the owned copy only backs GetLayout and the debug arrays
+	SpawnRooms(File.GetView(), RoomTypes);
+	File.GetView().ToLayout(Layout);
+	CommitPaths(CorridorBP);
+	return true;
+}
+
+bool URoomManager::IsRoomAt(const FVector& Location) const
+{
+	return OccupancyGrid.IsSetAt(FDungeonOccupancyGrid::ELayer::Room, FVector2f(Location.X, Location.Y));
+}
+
+bool URoomManager::IsCorridorAt(const FVector& Location) const
+{
+	return OccupancyGrid.IsSetAt(FDungeonOccupancyGrid::ELayer::Corridor, FVector2f(Location.X, Location.Y));
+}
+
+FDungeonGenerationSettings URoomManager::MakeGenerationSettings(int NbRoom, const TArray<FRoomType>& RoomTypes,
+	TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, int32 Seed)
+{
+	FDungeonGenerationSettings Settings;
+	Settings.NbRoom = NbRoom;
+	Settings.Seed = Seed;
+	Settings.RoomTypes.Reserve(RoomTypes.Num());
+
+	for (const FRoomType& RoomType : RoomTypes)
+	{
+		FDungeonRoomTypeDesc& Desc = Settings.RoomTypes.AddDefaulted_GetRef();
+		Desc.Probability = RoomType.Probability;
+		Desc.SizeMin = RoomType.SizeMin;
+		Desc.SizeMax = RoomType.SizeMax;
+
+		// Read the box size from the class default object, no actor is spawned
+		const ARoomParent* DefaultRoom = RoomType.TypeOfRoomToSpawn ? RoomType.TypeOfRoomToSpawn->GetDefaultObject<ARoomParent>() : nullptr;
+		if (DefaultRoom && DefaultRoom->BoxCollision)
+		{
+			const FVector Extent = DefaultRoom->BoxCollision->GetUnscaledBoxExtent();
+			Desc.BaseExtent = FVector2f(Extent.X, Extent.Y);
+		}
+
+		if (RoomP && RoomType.TypeOfRoomToSpawn && RoomType.TypeOfRoomToSpawn->IsChildOf(RoomP))
+		{
+			Desc.Role = EDungeonRoomRole::Primary;
+		}
+		else if (RoomS && RoomType.TypeOfRoomToSpawn && RoomType.TypeOfRoomToSpawn->IsChildOf(RoomS))
+		{
+			Desc.Role = EDungeonRoomRole::Secondary;
 		}
 	}
-	// Resolve any overlapping rooms using physics-based separation
-	ResolveRoomOverlaps(SpawnedActors);
+
+	return Settings;
+}
+
+int32 URoomManager::ResolveSeed(int32 Seed)
+{
+	LastSeed = Seed >= 0 ? Seed : FDungeonGenerator::MakeRandomSeed();
+	return LastSeed;
+}
+
+void URoomManager::SpawnRooms(const FDungeonLayoutView& InLayout, const TArray<FRoomType>& RoomTypes)
+{
+	DUNGEON_SCOPE_STAGE(SpawnRooms);
+	SpawnedActors.Reserve(SpawnedActors.Num() + InLayout.NumRooms());
+	for (int32 RoomIndex = 0; RoomIndex < InLayout.NumRooms(); ++RoomIndex)
+	{
+		SpawnRoom(InLayout, RoomTypes, RoomIndex);
+	}
+}
+
+void URoomManager::SpawnRoom(const FDungeonLayoutView& InLayout, const TArray<FRoomType>& RoomTypes, int32 RoomIndex)
+{
+	// A loaded layout may come from another room type list
+	const int32 TypeId = InLayout.RoomTypeIds[RoomIndex];
+	if (!InLayout.RoomKept[RoomIndex] || !RoomTypes.IsValidIndex(TypeId))
+	{
+		return;
+	}
+
+	const FVector2f& Scale = InLayout.RoomScales[RoomIndex];
+	ARoomParent* Room = ActorPool.Acquire(GetWorld(), RoomTypes[TypeId].TypeOfRoomToSpawn, InLayout.GetRoomLocation(RoomIndex), FRotator::ZeroRotator);
+	if (Room)
+	{
+		Room->SetActorScale3D(FVector(Scale.X, Scale.Y, 1));
+		SpawnedActors.Add(Room);
+	}
 }
 
 void URoomManager::MegaTriangle(TSubclassOf<ARoomParent> Room)
@@ -86,12 +594,9 @@ void URoomManager::MegaTriangle(TSubclassOf<ARoomParent> Room)
 	
 	
 	
-	AActor* UpTriangle = GetWorld()->SpawnActor(Room);
-	UpTriangle->SetActorLocation(FVector(avgX,avgY+difY*10,0));
-	AActor* LeftTriangle = GetWorld()->SpawnActor(Room);
-	LeftTriangle->SetActorLocation(FVector(avgX-difX*5,avgY-difY*5,0));
-	AActor* RightTriangle = GetWorld()->SpawnActor(Room);
-	RightTriangle->SetActorLocation(FVector(avgX+difX*5,avgY-difY*5,0));
+	AActor* UpTriangle = ActorPool.Acquire(GetWorld(), Room, FVector(avgX,avgY+difY*10,0), FRotator::ZeroRotator);
+	AActor* LeftTriangle = ActorPool.Acquire(GetWorld(), Room, FVector(avgX-difX*5,avgY-difY*5,0), FRotator::ZeroRotator);
+	AActor* RightTriangle = ActorPool.Acquire(GetWorld(), Room, FVector(avgX+difX*5,avgY-difY*5,0), FRotator::ZeroRotator);
 
 	OtherActorsToClear.Add(UpTriangle);
 	OtherActorsToClear.Add(LeftTriangle);
@@ -103,14 +608,15 @@ void URoomManager::MegaTriangle(TSubclassOf<ARoomParent> Room)
 	MegaTrianglePointC = RightTriangle->GetActorLocation();
 	
 	AllTriangles.Add(FTriangle(MegaTrianglePointA, MegaTrianglePointB, MegaTrianglePointC));
-	FTriangle t = AllTriangles.Last();
-	t.DrawTriangle(GetWorld());
+	RefreshDebugLayer(EDungeonDebugLayer::Triangles);
+	ShowDebugLayer(EDungeonDebugLayer::Triangles);
 }
 
 void URoomManager::Triangulation(TSubclassOf<ARoomParent> RoomP)
 {
+	DUNGEON_SCOPE_STAGE(Triangulate);
 	TArray<AActor*> RoomPrincipal;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(),RoomP,RoomPrincipal);
+	GetActiveActorsOfClass(RoomP, RoomPrincipal);
 
 	if (AllTriangles.Num() <= 0)
 	{
@@ -118,107 +624,85 @@ void URoomManager::Triangulation(TSubclassOf<ARoomParent> RoomP)
 		return;
 	}
 	
-	// Delaunay triangulation: insert each room point one by one
+	TArray<FVector2D> Points;
+	Points.Reserve(RoomPrincipal.Num());
 	for (AActor* Room : RoomPrincipal)
 	{
-		FVector RoomLocation = Room->GetActorLocation();
-		
-		// STEP 1: Find all triangles whose circumcircle contains the new point
-		TArray<FTriangle> BadTriangles;
-		
-		// Check ALL existing triangles, not just the recently created ones
-		for (const FTriangle& Triangle : AllTriangles)
-		{
-			FVector CenterCircle;
-			if (Triangle.CenterCircle(CenterCircle))
-			{
-				float Dist = FVector::Dist(CenterCircle, RoomLocation);
-				if (Dist <= Triangle.GetRayon())
-				{
-					BadTriangles.Add(Triangle);
-				}
-			}
-		}
-		
-		// STEP 2: Remove all invalid triangles
-		for (const FTriangle& BadTriangle : BadTriangles)
-		{
-			AllTriangles.RemoveSingle(BadTriangle);
-		}
-		
-		// STEP 3: Collect all edges from removed triangles
-		TArray<FTriangleEdge> AllEdges;
-		for (const FTriangle& BadTriangle : BadTriangles)
-		{
-			TArray<FTriangleEdge> TriangleEdges = BadTriangle.GetEdges();
-			AllEdges.Append(TriangleEdges);
-		}
+		const FVector RoomLocation = Room->GetActorLocation();
+		Points.Add(FVector2D(RoomLocation.X, RoomLocation.Y));
+	}
 
-		// STEP 4: Identify boundary edges (edges that appear exactly once)
-		TArray<FTriangleEdge> BoundaryEdges;
-		for (int32 EdgeIdx = 0; EdgeIdx < AllEdges.Num(); ++EdgeIdx)
+	// Triangles as indices into Points
+	const FVector2D SuperA(MegaTrianglePointA), SuperB(MegaTrianglePointB), SuperC(MegaTrianglePointC);
+	TArray<FIntVector> PointTriangles;
+	if (!bParallelTriangulation || Points.Num() < FParallelDelaunay::MinParallelPoints
+		|| !FParallelDelaunay::Triangulate(Points, SuperA, SuperB, SuperC, PointTriangles))
+	{
+		// Delaunay triangulation: insert each room point into an indexed mesh seeded with the mega-triangle
+		FDelaunayMesh Mesh;
+		Mesh.Init(SuperA, SuperB, SuperC, Points.Num());
+
+		TArray<int32> InsertionOrder;
+		FDelaunayMesh::SortForInsertion(Points, InsertionOrder);
+		TArray<int32> PointByVertex;
+		PointByVertex.Init(INDEX_NONE, Points.Num());
+		for (int32 PointIndex : InsertionOrder)
 		{
-			if (AllEdges[EdgeIdx].PointA.IsZero() && AllEdges[EdgeIdx].PointB.IsZero()) 
-				continue; // Skip edges marked as deleted
-			
-			int32 Count = 1;
-			// Count how many times this edge appears
-			for (int32 j = EdgeIdx + 1; j < AllEdges.Num(); ++j)
+			const int32 Vertex = Mesh.Insert(Points[PointIndex]) - FDelaunayMesh::NumSuperVertices;
+			if (Vertex < -FDelaunayMesh::NumSuperVertices)
 			{
-				if (AllEdges[EdgeIdx] == AllEdges[j])
-				{
-					Count++;
-					// Mark edge as processed
-					AllEdges[j].PointA = FVector::ZeroVector;
-					AllEdges[j].PointB = FVector::ZeroVector;
-				}
+				UE_LOG(LogTemp, Warning, TEXT("Room (%.0f,%.0f) is outside the mega-triangle!"), Points[PointIndex].X, Points[PointIndex].Y);
 			}
-			
-			// If edge appears exactly once, it's a boundary edge
-			if (Count == 1)
+			else if (Vertex >= 0 && PointByVertex[Vertex] == INDEX_NONE)
 			{
-				BoundaryEdges.Add(AllEdges[EdgeIdx]);
+				PointByVertex[Vertex] = PointIndex;
 			}
 		}
 
-		// STEP 5: Create new triangles by connecting the point to each boundary edge
-		for (const FTriangleEdge& Edge : BoundaryEdges)
+		// Triangles connected to the mega-triangle are already left out by the mesh
+		Mesh.GetTriangles(PointTriangles);
+		for (FIntVector& Tri : PointTriangles)
 		{
-			FTriangle NewTriangle(RoomLocation, Edge.PointA, Edge.PointB);
-			AllTriangles.Add(NewTriangle);
+			Tri = FIntVector(PointByVertex[Tri.X], PointByVertex[Tri.Y], PointByVertex[Tri.Z]);
 		}
-		
-		DrawDebugSphere(GetWorld(), RoomLocation, 50, 50, FColor(0,0,0), true, -1, 0, 50);
+		FDelaunayMesh::PublishCounters(Mesh.GetCounters());
+	}
+
+	FParallelDelaunay::SortTriangles(PointTriangles);
+	AllTriangles.Reset(PointTriangles.Num());
+	for (const FIntVector& Tri : PointTriangles)
+	{
+		AllTriangles.Add(FTriangle(FVector(Points[Tri.X], 0), FVector(Points[Tri.Y], 0), FVector(Points[Tri.Z], 0)));
 	}
-	
-	// Remove triangles connected to the mega-triangle
-	RemoveSuperTriangles();
 
 	TriangulationDone = true;
 	
+	RefreshDebugLayer(EDungeonDebugLayer::Triangles);
 	DrawAll();
-	UE_LOG(LogTemp, Display, TEXT("=== [Delaunay Triangles] ==="));
-	for (const FTriangle& Tri : AllTriangles)
+	if (DungeonStats::IsLayoutDumpEnabled())
 	{
-		UE_LOG(LogTemp, Display, TEXT("Triangle: (%.0f,%.0f) | (%.0f,%.0f) | (%.0f,%.0f)"),
-			Tri.PointA.X, Tri.PointA.Y,
-			Tri.PointB.X, Tri.PointB.Y,
-			Tri.PointC.X, Tri.PointC.Y);
+		UE_LOG(LogTemp, Display, TEXT("=== [Delaunay Triangles] ==="));
+		for (const FTriangle& Tri : AllTriangles)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Triangle: (%.0f,%.0f) | (%.0f,%.0f) | (%.0f,%.0f)"),
+				Tri.PointA.X, Tri.PointA.Y,
+				Tri.PointB.X, Tri.PointB.Y,
+				Tri.PointC.X, Tri.PointC.Y);
+		}
+		UE_LOG(LogTemp, Display, TEXT("=============================="));
 	}
-	UE_LOG(LogTemp, Display, TEXT("=============================="));
 	UE_LOG(LogTemp, Display, TEXT("Triangulation completed!"))
 }
 
 void URoomManager::	CreatePath(TSubclassOf<ARoomParent> RoomP)
 {
+	DUNGEON_SCOPE_STAGE(CreatePath);
 	if (!TriangulationDone)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Complete triangulation first!"));
 		return;
 	}
 	ClearDrawAll();
-	TArray<AActor*> RoomPrincipal;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(),RoomP,RoomPrincipal);
 
 	if (AllTriangles.Num() <= 0)
 	{
@@ -226,119 +710,60 @@ void URoomManager::	CreatePath(TSubclassOf<ARoomParent> RoomP)
 		return;
 	}
 
-	// Prim's algorithm to create minimum spanning tree
-	TSet<FVector> PointAlreadyUsed;
-	TSet<FTriangleEdge> AllEdges;
-	TMap<float,TSet<FTriangleEdge>> PointsSortedByDistance;
-	FVector RoomLocation = RoomPrincipal[0]->GetActorLocation();
+	// Index the triangulated room positions so the MST works on vertex indices
+	TMap<FVector, int32> VertexIndices;
+	TArray<FVector2f> Vertices;
+	TArray<FIntVector> Triangles;
+	Triangles.Reserve(AllTriangles.Num());
 
-	// Build MST by selecting shortest edges to unvisited nodes
-	while (PointAlreadyUsed.Num() < RoomPrincipal.Num())
+	// A planar triangulation has about half as many vertices as triangles
+	VertexIndices.Reserve(AllTriangles.Num() / 2 + 3);
+	Vertices.Reserve(AllTriangles.Num() / 2 + 3);
+	auto GetVertexIndex = [&VertexIndices, &Vertices](const FVector& Point)
 	{
-		PointAlreadyUsed.Add(RoomLocation);
-		
-		for (FTriangle TriangleToCheck : AllTriangles)
+		if (const int32* Existing = VertexIndices.Find(Point))
 		{
-			if (TriangleToCheck.GetAllPoints().Contains(RoomLocation))
-			{
-				for (const FTriangleEdge& TrianglesEdge : TriangleToCheck.GetEdges())
-				{
-					if (PointAlreadyUsed.Contains(TrianglesEdge.PointA) && PointAlreadyUsed.Contains(TrianglesEdge.PointB))
-					{
-						continue;
-					}
-					if (TrianglesEdge.PointA == RoomLocation || TrianglesEdge.PointB == RoomLocation)
-					{
-						AllEdges.Add(TrianglesEdge);
-						if (!PointsSortedByDistance.Contains(TrianglesEdge.GetLength()))
-						{
-							PointsSortedByDistance.Add(TrianglesEdge.GetLength(), TSet<FTriangleEdge>());
-						}
-
-						PointsSortedByDistance[TrianglesEdge.GetLength()].Add(TrianglesEdge);
-					}
-				}
-			}
+			return *Existing;
 		}
+		const int32 NewIndex = Vertices.Add(FVector2f(Point.X, Point.Y));
+		VertexIndices.Add(Point, NewIndex);
+		return NewIndex;
+	};
+	for (const FTriangle& Triangle : AllTriangles)
+	{
+		Triangles.Add(FIntVector(GetVertexIndex(Triangle.PointA), GetVertexIndex(Triangle.PointB), GetVertexIndex(Triangle.PointC)));
+	}
 
-		TArray<float> DistancesToRemove;
-		bool HaveToEnd = false;
-		
-		for (auto& [distance, EdgesSorted] : PointsSortedByDistance)
-		{
-			TArray<FTriangleEdge> EdgeToRemove;
-			for (const FTriangleEdge& EdgeToUse : EdgesSorted)
-			{
+	// Kruskal's algorithm over the Delaunay edges
+	TArray<FIntPoint> Edges;
+	TArray<FIntPoint> TreeEdges;
+	FMinimumSpanningTree::GetUniqueEdges(Triangles, Edges);
+	FMinimumSpanningTree::Build(Vertices, Edges, TreeEdges);
 
-				if (PointAlreadyUsed.Contains(EdgeToUse.PointA) && PointAlreadyUsed.Contains(EdgeToUse.PointB))
-				{
-					EdgeToRemove.Add(EdgeToUse);
-					continue;
-				}
-				
-				if (EdgeToUse.PointA == RoomLocation)
-				{
-					RoomLocation = EdgeToUse.PointB;
-				}
-				else
-				{
-					RoomLocation = EdgeToUse.PointA;
-				}
-				
-				FirstPath.Add(EdgeToUse);
-				EdgeToRemove.Add(EdgeToUse);
-				HaveToEnd = true;
-				break;
-				
-			}
-
-			if (EdgeToRemove.Num() > 0)
-			{
-				for (const FTriangleEdge& ToRemove : EdgeToRemove)
-				{
-					EdgesSorted.Remove(ToRemove);
-					if (EdgesSorted.Num() <= 0)
-					{
-						DistancesToRemove.Add(distance);
-					}
-					
-				}
-			}
-			
-			if (HaveToEnd)
-			{
-				break;
-			}
-			
-		}
-		
-		if (DistancesToRemove.Num() > 0)
-		{
-			for (const float& DistanceToUse : DistancesToRemove)
-			{
-				PointsSortedByDistance.Remove(DistanceToUse);
-			}
-		}
-		
-	}
-	
-	UE_LOG(LogTemp, Display, TEXT("=== [MST - FirstPath] ==="));
-	for (const FTriangleEdge& Edge : FirstPath)
+	FirstPath.Reset(TreeEdges.Num());
+	for (const FIntPoint& Edge : TreeEdges)
 	{
-		UE_LOG(LogTemp, Display, TEXT("Edge: (%.0f,%.0f) -> (%.0f,%.0f)"),
-			Edge.PointA.X, Edge.PointA.Y,
-			Edge.PointB.X, Edge.PointB.Y);
+		FirstPath.Add(FTriangleEdge(FVector(Vertices[Edge.X].X, Vertices[Edge.X].Y, 0), FVector(Vertices[Edge.Y].X, Vertices[Edge.Y].Y, 0)));
 	}
-	UE_LOG(LogTemp, Display, TEXT("==========================="));
-	for (const FTriangleEdge& singlePath : FirstPath)
+	
+	if (DungeonStats::IsLayoutDumpEnabled())
 	{
-		singlePath.DrawEdge(GetWorld());
+		UE_LOG(LogTemp, Display, TEXT("=== [MST - FirstPath] ==="));
+		for (const FTriangleEdge& Edge : FirstPath)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Edge: (%.0f,%.0f) -> (%.0f,%.0f)"),
+				Edge.PointA.X, Edge.PointA.Y,
+				Edge.PointB.X, Edge.PointB.Y);
+		}
+		UE_LOG(LogTemp, Display, TEXT("==========================="));
 	}
-	
+	RefreshDebugLayer(EDungeonDebugLayer::Path);
+	ShowDebugLayer(EDungeonDebugLayer::Path);
 }
 
 void URoomManager::EvolvePath()
 {
+	DUNGEON_SCOPE_STAGE(EvolvePath);
 	if (!TriangulationDone)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Complete triangulation first!"));
@@ -346,7 +771,8 @@ void URoomManager::EvolvePath()
 	}
 	// Clear previous path visualizations
 	ClearDrawAll();
-	EvolvedPath.Empty();
+	EvolvedPath.Reset();
+	const FRandomStream Random = FDungeonGenerator::MakeStageStream(LastSeed, EDungeonStage::EvolvePath);
 
 	// Transform each MST edge into L-shaped corridors for better navigation
 	for (const FTriangleEdge& EdgeToCheck : FirstPath)
@@ -365,7 +791,7 @@ void URoomManager::EvolvePath()
 			// - (A.x, B.y): horizontal first, then vertical
 			// - (B.x, A.y): vertical first, then horizontal
 			// Choose randomly for variation
-			if (FMath::RandBool())
+			if (Random.FRand() < 0.5f)
 				Intersection = FVector(EdgeToCheck.PointA.X, EdgeToCheck.PointB.Y, 0);
 			else
 				Intersection = FVector(EdgeToCheck.PointB.X, EdgeToCheck.PointA.Y, 0);
@@ -377,30 +803,32 @@ void URoomManager::EvolvePath()
 	}
 
 	// Draw all generated paths for editor visualization
-	for (const auto& Edge : EvolvedPath)
-	{
-		Edge.DrawEdge(GetWorld());
-	}
-	UE_LOG(LogTemp, Display, TEXT("=== [Evolved Path - L-shapes] ==="));
-	for (const FTriangleEdge& Edge : EvolvedPath)
+	RefreshDebugLayer(EDungeonDebugLayer::Corridors);
+	ShowDebugLayer(EDungeonDebugLayer::Corridors);
+	if (DungeonStats::IsLayoutDumpEnabled())
 	{
-		UE_LOG(LogTemp, Display, TEXT("Path: (%.0f,%.0f) -> (%.0f,%.0f)"),
-			Edge.PointA.X, Edge.PointA.Y,
-			Edge.PointB.X, Edge.PointB.Y);
+		UE_LOG(LogTemp, Display, TEXT("=== [Evolved Path - L-shapes] ==="));
+		for (const FTriangleEdge& Edge : EvolvedPath)
+		{
+			UE_LOG(LogTemp, Display, TEXT("Path: (%.0f,%.0f) -> (%.0f,%.0f)"),
+				Edge.PointA.X, Edge.PointA.Y,
+				Edge.PointB.X, Edge.PointB.Y);
+		}
+		UE_LOG(LogTemp, Display, TEXT("==============================="));
 	}
-	UE_LOG(LogTemp, Display, TEXT("==============================="));
 
 }
 
 void URoomManager::ClearSecondaryRoom(TSubclassOf<ARoomParent> SecondaryRoomType)
 {
+	DUNGEON_SCOPE_STAGE(ClearSecondaryRooms);
 	if (!TriangulationDone)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Complete triangulation first!"));
 		return;
 	}
 	TArray<AActor*> AllSecondaryRoom;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(),SecondaryRoomType,AllSecondaryRoom);
+	GetActiveActorsOfClass(SecondaryRoomType, AllSecondaryRoom);
 
 	if (AllTriangles.Num() <= 0)
 	{
@@ -413,7 +841,18 @@ void URoomManager::ClearSecondaryRoom(TSubclassOf<ARoomParent> SecondaryRoomType
 		return;
 	}
 
+	// Corridor segments in a BVH so each room only tests the nearby ones
+	TArray<FDungeonSegment> Segments;
+	Segments.Reserve(EvolvedPath.Num());
+	for (const FTriangleEdge& EdgeToCheck : EvolvedPath)
+	{
+		Segments.Emplace(FVector2f(EdgeToCheck.PointA.X, EdgeToCheck.PointA.Y), FVector2f(EdgeToCheck.PointB.X, EdgeToCheck.PointB.Y));
+	}
+	FSegmentBVH CorridorBVH;
+	CorridorBVH.Build(Segments);
+
 	// Remove secondary rooms that don't intersect with corridor paths
+	int32 NumSegmentTests = 0;
 	for (int SecondaryRoomIndex = 0; SecondaryRoomIndex < AllSecondaryRoom.Num(); ++SecondaryRoomIndex)
 	{
 		AActor* SecondaryRoom = AllSecondaryRoom[SecondaryRoomIndex];
@@ -429,27 +868,19 @@ void URoomManager::ClearSecondaryRoom(TSubclassOf<ARoomParent> SecondaryRoomType
 		FVector BoxExtent = RoomParent->BoxCollision->GetScaledBoxExtent();
 		FVector RoomLocation = SecondaryRoom->GetActorLocation();
 		
-		bool IsInPath = false;
-		
 		// Check if room intersects with at least one corridor segment
-		for (const FTriangleEdge& EdgeToCheck : EvolvedPath)
-		{
-			// Use BoxExtent * 2 to get full box size
-			if (IsSegmentIntersectingBox(EdgeToCheck.PointA, EdgeToCheck.PointB, RoomLocation, BoxExtent * 2.0f))
-			{
-				IsInPath = true;
-				break;
-			}
-		}
+		const bool IsInPath = CorridorBVH.IntersectsBox(FVector2f(RoomLocation.X, RoomLocation.Y), FVector2f(BoxExtent.X, BoxExtent.Y), &NumSegmentTests);
 		
-		// Destroy room only if it's NOT in the path
+		// Release room only if it's NOT in the path
 		if (!IsInPath)
 		{
-			SecondaryRoom->Destroy();
+			ActorPool.Release(SecondaryRoom);
 		}
 
 	}
+	INC_DWORD_STAT_BY(STAT_DungeonSegmentBoxTests, NumSegmentTests);
 
+	SpawnedActors.RemoveAll([](const ARoomParent* Room) { return FDungeonActorPool::IsPooled(Room); });
 }
 // Ray-box intersection test for corridor-room collision detection
 // Width = X, Height = Z, Depth = Y
@@ -494,63 +925,36 @@ bool URoomManager::IsSegmentIntersectingBox(const FVector& PointA, const FVector
 	return true;
 }
 
-// Main overlap resolution function using physics-based separation
+// Main overlap resolution function, runs the headless solver on the actors' boxes
 void URoomManager::ResolveRoomOverlaps(TArray<ARoomParent*>& SpawnedActorsRaw)
 {
-    if (SpawnedActorsRaw.Num() == 0) return;
-
-	// Randomize processing order for more varied results
-	TArray<ARoomParent*> SpawnedActorsToUse = SpawnedActorsRaw;
-
-	int32 Num = SpawnedActorsToUse.Num();
-	for (int32 i = 0; i < Num - 1; i++)
+	TArray<ARoomParent*> Rooms;
+	TArray<FVector2f> Centers;
+	TArray<FVector2f> Extents;
+	Rooms.Reserve(SpawnedActorsRaw.Num());
+	Centers.Reserve(SpawnedActorsRaw.Num());
+	Extents.Reserve(SpawnedActorsRaw.Num());
+
+	for (ARoomParent* Room : SpawnedActorsRaw)
 	{
-		int32 SwapIndex = FMath::RandRange(i, Num - 1);
-		if (i != SwapIndex)
-		{
-			SpawnedActorsToUse.Swap(i, SwapIndex);
-		}
-	}
-    
-    for (ARoomParent* CurrentRoom : SpawnedActorsToUse)
-    {
-        if (!CurrentRoom || !CurrentRoom->BoxCollision) continue;
-
-        FVector LocationA = CurrentRoom->GetActorLocation();
-        FVector RepulsionDirection = FVector(
-			FMath::FRandRange(-1, 1.), 
-			FMath::FRandRange(-1, 1.),
-			0
-		);
-    	
-    	
-        bool haveToMove = true;
-        while (haveToMove)
-        {
-			haveToMove = false;
+		if (!Room || !Room->BoxCollision) continue;
 
-			for (ARoomParent*& RoomToCheck : SpawnedActorsToUse)
-			{
-				if (!RoomToCheck || !RoomToCheck->BoxCollision) continue;
-				if (RoomToCheck == CurrentRoom) continue;
+		const FVector Location = Room->BoxCollision->GetComponentLocation();
+		const FVector Extent = Room->BoxCollision->GetScaledBoxExtent();
+		Rooms.Add(Room);
+		Centers.Add(FVector2f(Location.X, Location.Y));
+		Extents.Add(FVector2f(Extent.X, Extent.Y));
+	}
 
-				if (CheckOverlapping(CurrentRoom->BoxCollision, RoomToCheck->BoxCollision))
-				{
-					haveToMove = true;
-					if (!RepulsionDirection.IsNearlyZero())
-					{
-						RepulsionDirection.Normalize();
-		            
-						float MoveDistance = 1000.0f;
-						CurrentRoom->AddActorLocalOffset(RepulsionDirection * MoveDistance);
-						break;
-					}
-				}
-			}
-        	
-        }
+	FOverlapSolverSettings SolverSettings;
+	SolverSettings.Seed = FDungeonGenerator::MakeStageStream(LastSeed, EDungeonStage::ResolveOverlaps).GetCurrentSeed();
+	FDungeonGenerator::ResolveOverlaps(Centers, Extents, SolverSettings);
 
-    }
+	for (int32 RoomIndex = 0; RoomIndex < Rooms.Num(); ++RoomIndex)
+	{
+		const FVector Location = Rooms[RoomIndex]->GetActorLocation();
+		Rooms[RoomIndex]->SetActorLocation(FVector(Centers[RoomIndex].X, Centers[RoomIndex].Y, Location.Z));
+	}
 }
 
 
@@ -605,61 +1009,136 @@ void URoomManager::StopAutoDemo()
 void URoomManager::DrawAll()
 {
 	ClearDrawAll();
-	if (AllTriangles.Num() > 0)
+	ShowDebugLayer(EDungeonDebugLayer::Triangles);
+}
+
+void URoomManager::ClearDrawAll()
+{
+	// Hidden layers keep their lines, showing them again costs nothing
+	if (!IsValid(DebugDraw))
 	{
-		for (FTriangle& Triangle : AllTriangles)
-		{
-			Triangle.DrawTriangle(GetWorld());
-		}
+		return;
 	}
+	DebugDraw->SetLayerVisible(EDungeonDebugLayer::Triangles, false);
+	DebugDraw->SetLayerVisible(EDungeonDebugLayer::Path, false);
+	DebugDraw->SetLayerVisible(EDungeonDebugLayer::Corridors, false);
+	DebugDraw->ClearLayer(EDungeonDebugLayer::Overlay);
 }
 
-void URoomManager::ClearDrawAll()
+UDungeonDebugDrawComponent* URoomManager::GetDebugDraw()
+{
+	// Same setup as the corridor instances
+	if (!IsValid(DebugDraw))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		DebugDrawActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!DebugDrawActor) return nullptr;
+
+		DebugDraw = NewObject<UDungeonDebugDrawComponent>(DebugDrawActor, TEXT("DebugDraw"));
+		DebugDrawActor->SetRootComponent(DebugDraw);
+		DebugDrawActor->AddInstanceComponent(DebugDraw);
+		DebugDraw->RegisterComponent();
+	}
+	return DebugDraw;
+}
+
+void URoomManager::RefreshDebugLayer(EDungeonDebugLayer Layer)
+{
+	UDungeonDebugDrawComponent* Draw = GetDebugDraw();
+	if (!Draw) return;
+
+	switch (Layer)
+	{
+	case EDungeonDebugLayer::Triangles: Draw->SetTriangles(Layer, AllTriangles, FColor(0, 255, 0)); break;
+	case EDungeonDebugLayer::Path: Draw->SetEdges(Layer, FirstPath, FColor::Cyan); break;
+	case EDungeonDebugLayer::Corridors: Draw->SetEdges(Layer, EvolvedPath, FColor::Green); break;
+	default: break;
+	}
+}
+
+void URoomManager::ShowDebugLayer(EDungeonDebugLayer Layer)
 {
-	FlushPersistentDebugLines(GetWorld());
+	if (UDungeonDebugDrawComponent* Draw = GetDebugDraw())
+	{
+		Draw->SetLayerVisible(Layer, true);
+	}
 }
 
 void URoomManager::ClearAll()
 {
-	AllTriangles.Empty();
-	TriangleErased.Empty();
-	LastTrianglesCreated.Empty();
-	FirstPath.Empty();
-	EvolvedPath.Empty();
+	CancelAsyncGeneration();
+	CancelTimeSlicedGeneration();
+
+	// Reset keeps the capacity, the next generation refills these arrays without reallocating
+	AllTriangles.Reset();
+	TriangleErased.Reset();
+	LastTrianglesCreated.Reset();
+	FirstPath.Reset();
+	EvolvedPath.Reset();
+	CorridorsToSpawn.Reset();
+	CorridorRuns.Reset();
 	ResetStepByStep();
 	RemoveSuperTriangles();
 	
 	TriangulationDone = false;
 	
+	// Actors go back to the pool instead of being destroyed, the next generation reuses them
 	for (ARoomParent* SpawnedActor : SpawnedActors)
 	{
-		if (IsValid(SpawnedActor))
-		{
-			SpawnedActor->Destroy();
-		}
+		ActorPool.Release(SpawnedActor);
 	}
-	SpawnedActors.Empty();
+	SpawnedActors.Reset();
 
 	for (AActor* SpawnedActor : OtherActorsToClear)
 	{
-		if (IsValid(SpawnedActor))
-		{
-			SpawnedActor->Destroy();
-		}
+		ActorPool.Release(SpawnedActor);
 	}
-	OtherActorsToClear.Empty();
+	OtherActorsToClear.Reset();
+
+	if (IsValid(CorridorInstances))
+	{
+		CorridorInstances->ClearInstances();
+	}
+
+	Layout.Reset();
+	OccupancyGrid.Reset();
 	ClearDrawAll();
+	if (IsValid(DebugDraw))
+	{
+		DebugDraw->ClearAllLayers();
+	}
 
 	CurrentStep = 0;
 	CurrentLittleStep = 0;
 }
 
+void URoomManager::PrewarmActorPool(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	ActorPool.Prewarm(GetWorld(), ActorClass, Count);
+}
+
+void URoomManager::EmptyActorPool()
+{
+	ActorPool.Empty();
+}
+
+FDungeonActorPoolStats URoomManager::GetActorPoolStats() const
+{
+	return ActorPool.GetStats();
+}
+
+void URoomManager::GetActiveActorsOfClass(TSubclassOf<AActor> ActorClass, TArray<AActor*>& OutActors) const
+{
+	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ActorClass, OutActors);
+	OutActors.RemoveAll([](const AActor* Actor) { return FDungeonActorPool::IsPooled(Actor); });
+}
+
 void URoomManager::RemoveSuperTriangles()
 {
 	// Remove all triangles that share a vertex with the mega-triangle
 	AllTriangles.RemoveAll([this](const FTriangle& Triangle) {
-		TArray<FVector> Points = Triangle.GetAllPoints();
-		for (const FVector& Point : Points)
+		for (const FVector& Point : Triangle.GetAllPoints())
 		{
 			if (Point.Equals(MegaTrianglePointA, 1.0f) || 
 				Point.Equals(MegaTrianglePointB, 1.0f) || 
@@ -670,6 +1149,10 @@ void URoomManager::RemoveSuperTriangles()
 		}
 		return false; // Keep this triangle
 	});
+	if (IsValid(DebugDraw))
+	{
+		RefreshDebugLayer(EDungeonDebugLayer::Triangles);
+	}
 }
 
 template<typename T>
@@ -684,6 +1167,7 @@ const T* URoomManager::GetAnyElement(const TSet<T>& Set)
 
 void URoomManager::SpawnConnectionModules(TSubclassOf<AActor> CorridorBP)
 {
+	DUNGEON_SCOPE_STAGE(SpawnCorridors);
 	if (!TriangulationDone)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Complete triangulation first!"));
@@ -696,40 +1180,151 @@ void URoomManager::SpawnConnectionModules(TSubclassOf<AActor> CorridorBP)
 		return;
 	}
 
+	BuildCorridorsToSpawn();
+	for (const FTriangleEdge& Edge : CorridorsToSpawn)
+	{
+		SpawnCorridor(Edge, CorridorBP);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("✅ Connection modules generated (%d segments, %d corridors, %d junctions)."),
+		EvolvedPath.Num(), CorridorsToSpawn.Num(), CorridorRuns.GetJunctions().Num());
+}
+
+void URoomManager::SpawnCorridor(const FTriangleEdge& Edge, TSubclassOf<AActor> CorridorBP)
+{
+	FVector Start = Edge.PointA;
+	FVector End = Edge.PointB;
+
+	FVector Direction = End - Start;
+	float Length = Direction.Length();
+	Direction.Normalize();
+
+	// Calculate median position to place corridor
+	FVector Middle = Start + (Direction * (Length / 2));
+
+	// Calculate rotation
+	FRotator Rotation = Direction.Rotation();
+
+	// Spawn corridor, or reuse one released by a previous ClearAll
+	AActor* Corridor = ActorPool.Acquire(GetWorld(), CorridorBP, Middle, Rotation);
+	if (!Corridor) return;
+
+	// Scale according to segment length
+	FVector Scale = Corridor->GetActorScale3D();
+	Scale.X = Length / 100.0f; // Adjust "100" based on base mesh length
+	Corridor->SetActorScale3D(Scale);
+
+	// Optional: keep reference for cleanup later
+	OtherActorsToClear.Add(Corridor);
+}
+
+void URoomManager::BuildCorridorsToSpawn()
+{
+	if (!bMergeCorridors)
+	{
+		CorridorRuns.Reset();
+		CorridorsToSpawn = EvolvedPath;
+		return;
+	}
+
+	// Built from EvolvedPath rather than the layout, the step-by-step path fills only EvolvedPath
+	TArray<FDungeonSegment> Segments;
+	Segments.Reserve(EvolvedPath.Num());
 	for (const FTriangleEdge& Edge : EvolvedPath)
 	{
-		FVector Start = Edge.PointA;
-		FVector End = Edge.PointB;
+		Segments.Emplace(FVector2f(Edge.PointA.X, Edge.PointA.Y), FVector2f(Edge.PointB.X, Edge.PointB.Y));
+	}
+	CorridorRuns.Build(Segments);
 
-		FVector Direction = End - Start;
-		float Length = Direction.Length();
-		Direction.Normalize();
+	CorridorsToSpawn.Reset(CorridorRuns.GetRuns().Num());
+	for (const FDungeonSegment& Run : CorridorRuns.GetRuns())
+	{
+		CorridorsToSpawn.Add(FTriangleEdge(FVector(Run.A.X, Run.A.Y, 0), FVector(Run.B.X, Run.B.Y, 0)));
+	}
+}
 
-		// Calculate median position to place corridor
-		FVector Middle = Start + (Direction * (Length / 2));
+TArray<FVector> URoomManager::GetCorridorJunctions() const
+{
+	TArray<FVector> Junctions;
+	Junctions.Reserve(CorridorRuns.GetJunctions().Num());
+	for (const FVector2f& Junction : CorridorRuns.GetJunctions())
+	{
+		Junctions.Add(FVector(Junction.X, Junction.Y, 0));
+	}
+	return Junctions;
+}
 
-		// Calculate rotation
-		FRotator Rotation = Direction.Rotation();
+void URoomManager::SpawnInstancedConnectionModules(UStaticMesh* CorridorMesh, UMaterialInterface* CorridorMaterial, float MeshLength)
+{
+	DUNGEON_SCOPE_STAGE(SpawnCorridors);
+	if (!TriangulationDone)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Complete triangulation first!"));
+		return;
+	}
+	if (!CorridorMesh || MeshLength <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Instanced corridors need a mesh and a positive mesh length."));
+		return;
+	}
+	ClearDrawAll();
+	if (EvolvedPath.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No evolved paths available to create connection modules."));
+		return;
+	}
 
-		// Spawn corridor
+	// One actor and one component for every corridor, created on first use
+	if (!IsValid(CorridorInstances))
+	{
 		FActorSpawnParameters SpawnParams;
-		AActor* Corridor = GetWorld()->SpawnActor<AActor>(CorridorBP, Middle, Rotation, SpawnParams);
-		if (!Corridor) continue;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		CorridorInstancesActor = GetWorld()->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+		if (!CorridorInstancesActor) return;
+
+		CorridorInstances = NewObject<UHierarchicalInstancedStaticMeshComponent>(CorridorInstancesActor, TEXT("CorridorInstances"));
+		// Movable, once play has begun a registered Static component refuses any SetStaticMesh
+		CorridorInstances->SetMobility(EComponentMobility::Movable);
+		CorridorInstancesActor->SetRootComponent(CorridorInstances);
+		CorridorInstancesActor->AddInstanceComponent(CorridorInstances);
+		CorridorInstances->RegisterComponent();
+	}
 
-		// Scale according to segment length
-		FVector Scale = Corridor->GetActorScale3D();
-		Scale.X = Length / 100.0f; // Adjust "100" based on base mesh length
-		Corridor->SetActorScale3D(Scale);
+	CorridorInstances->ClearInstances();
+	CorridorInstances->SetStaticMesh(CorridorMesh);
+	if (CorridorMaterial)
+	{
+		CorridorInstances->SetMaterial(0, CorridorMaterial);
+	}
 
-		// Optional: keep reference for cleanup later
-		OtherActorsToClear.Add(Corridor);
+	// Same placement as the actor corridors: centered on the segment, X along it
+	BuildCorridorsToSpawn();
+	TArray<FTransform> Transforms;
+	Transforms.Reserve(CorridorsToSpawn.Num());
+	for (const FTriangleEdge& Edge : CorridorsToSpawn)
+	{
+		FVector Direction = Edge.PointB - Edge.PointA;
+		const float Length = Direction.Length();
+		if (Length <= KINDA_SMALL_NUMBER) continue;
+		Direction /= Length;
+
+		Transforms.Emplace(Direction.Rotation(), Edge.PointA + Direction * (Length / 2), FVector(Length / MeshLength, 1, 1));
 	}
 
-	UE_LOG(LogTemp, Display, TEXT("✅ Connection modules generated (%d segments)."), EvolvedPath.Num());
+	// Single batched add, the tree is built once for all instances
+	CorridorInstances->AddInstances(Transforms, false, true);
+
+	UE_LOG(LogTemp, Display, TEXT("Instanced connection modules generated (%d segments)."), Transforms.Num());
 }
 
 void URoomManager::StepByStep(TSubclassOf<ARoomParent> RoomP,TSubclassOf<ARoomParent> RoomS,TSubclassOf<ARoomParent> RoomC)
 {
+	if (IsGeneratingTimeSliced())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("A time-sliced generation is running, cancel it first."));
+		return;
+	}
+
 	UE_LOG(LogTemp, Display, TEXT("=== STEP BY STEP === Step: %d | SubStep: %d"), CurrentStep, CurrentLittleStep);
 
 	switch (CurrentStep)
@@ -748,6 +1343,12 @@ void URoomManager::StepByStep(TSubclassOf<ARoomParent> RoomP,TSubclassOf<ARoomPa
 void URoomManager::StartAutoDemo(TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS,
 	TSubclassOf<ARoomParent> RoomC, float StepDelaySeconds)
 {
+	if (IsGeneratingTimeSliced())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("A time-sliced generation is running, cancel it first."));
+		return;
+	}
+
 	// Store classes and timing
 	AutoRoomP = RoomP;
 	AutoRoomS = RoomS;
@@ -776,11 +1377,11 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
 		CurrentLittleStep = 0;
 		CurrentPointIndex = 0;
 		RoomPrincipallist.Empty();
-		UGameplayStatics::GetAllActorsOfClass(GetWorld(), RoomP, RoomPrincipallist);
-		FlushPersistentDebugLines(GetWorld());
+		GetActiveActorsOfClass(RoomP, RoomPrincipallist);
+		ClearDrawAll();
 	}
     if (RoomPrincipallist.Num() == 0)
-        UGameplayStatics::GetAllActorsOfClass(GetWorld(), RoomP, RoomPrincipallist);
+        GetActiveActorsOfClass(RoomP, RoomPrincipallist);
 
     if (AllTriangles.Num() == 0)
     {
@@ -801,6 +1402,8 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
 
     AActor* Room = RoomPrincipallist[CurrentPointIndex];
     FVector RoomLocation = Room->GetActorLocation();
+    UDungeonDebugDrawComponent* Draw = GetDebugDraw();
+    if (!Draw) return;
 
     switch (CurrentLittleStep)
     {
@@ -808,7 +1411,7 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
         case 0:
             ClearDrawAll();
     		RedrawStableState();
-            DrawDebugSphere(GetWorld(), RoomLocation, 100, 16, FColor::Blue, true, -1);
+            Draw->AddCircle(EDungeonDebugLayer::Overlay, RoomLocation, 100, FColor::Blue, 16);
             UE_LOG(LogTemp, Display, TEXT("[Step %d] Nouveau point (%.0f, %.0f)"), CurrentPointIndex, RoomLocation.X, RoomLocation.Y);
             CurrentLittleStep++;
             break;
@@ -818,32 +1421,23 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
     		ClearDrawAll();
     		RedrawStableState();
 
-    		for (const FTriangle& Tri : AllTriangles)
+    		TestCircumcircles(RoomLocation);
+    		for (int32 TriIndex = 0; TriIndex < AllTriangles.Num(); ++TriIndex)
     		{
+    			const FTriangle& Tri = AllTriangles[TriIndex];
     			FVector Center;
     			if (Tri.CenterCircle(Center))
     			{
     				float R = Tri.GetRayon();
-    				bool bInside = FVector::Dist(Center, RoomLocation) <= R;
+    				bool bInside = InCircumcircle[TriIndex];
 
-    				DrawDebugCircle(
-						GetWorld(),
-						Center,
-						R,
-						64,
+    				Draw->AddCircle(EDungeonDebugLayer::Overlay, Center, R,
 						bInside ? FColor::Red : FColor::Cyan, // rouge si point à l'intérieur, cyan sinon
-						true,  // bPersistentLines
-						-1,    // durée infinie
-						0,
-						20.f,
-						FVector(1, 0, 0),
-						FVector(0, 1, 0),
-						false
-					);
+						64, 20.f);
     			}
     		}
 
-    		DrawDebugSphere(GetWorld(), RoomLocation, 100, 16, FColor::Blue, true, -1);
+    		Draw->AddCircle(EDungeonDebugLayer::Overlay, RoomLocation, 100, FColor::Blue, 16);
     		UE_LOG(LogTemp, Display, TEXT("[Step %d] Circles tested for current point displayed"), CurrentPointIndex);
     		CurrentLittleStep++;
     		break;
@@ -853,20 +1447,15 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
             ClearDrawAll();
     		RedrawStableState();
             TriangleErased.Empty();
-            for (const FTriangle& Tri : AllTriangles)
+            TestCircumcircles(RoomLocation);
+            for (int32 TriIndex = 0; TriIndex < AllTriangles.Num(); ++TriIndex)
             {
-                FVector Center;
-                if (Tri.CenterCircle(Center))
+                const FTriangle& Tri = AllTriangles[TriIndex];
+                // Valid triangles are already drawn in green by the triangle layer
+                if (InCircumcircle[TriIndex])
                 {
-                    if (FVector::Dist(Center, RoomLocation) <= Tri.GetRayon())
-                    {
-                        TriangleErased.Add(Tri);
-                        Tri.DrawTriangle(GetWorld(), FColor::Red);
-                    }
-                    else
-                    {
-                        Tri.DrawTriangle(GetWorld(), FColor::Green);
-                    }
+                    TriangleErased.Add(Tri);
+                    Draw->AddTriangle(EDungeonDebugLayer::Overlay, Tri, FColor::Red);
                 }
             }
             UE_LOG(LogTemp, Display, TEXT("[Step %d] %d invalid triangles detected"), CurrentPointIndex, TriangleErased.Num());
@@ -883,7 +1472,8 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
             // Collect all edges
             TArray<FTriangleEdge> Edges;
             for (const FTriangle& T : TriangleErased)
-                Edges.Append(T.GetEdges());
+                for (const FTriangleEdge& Edge : T.GetEdges())
+                    Edges.Add(Edge);
 
             // Identify unique edges (boundaries)
             TArray<FTriangleEdge> Boundary;
@@ -903,17 +1493,18 @@ void URoomManager::StepByStepTriangulation(TSubclassOf<ARoomParent> RoomP)
                 if (Count == 1)
                 {
                     Boundary.Add(Edges[i]);
-                    Edges[i].DrawEdge(GetWorld(), FColor::Yellow);
+                    Draw->AddLine(EDungeonDebugLayer::Overlay, Edges[i].PointA, Edges[i].PointB, FColor::Yellow);
                 }
             }
 
             // Create new triangles
             for (const FTriangleEdge& Edge : Boundary)
             {
-                FTriangle NewTri(RoomLocation, Edge.PointA, Edge.PointB);
-                NewTri.DrawTriangle(GetWorld(), FColor::Green);
-                AllTriangles.Add(NewTri);
+                AllTriangles.Add(FTriangle(RoomLocation, Edge.PointA, Edge.PointB));
             }
+            RefreshDebugLayer(EDungeonDebugLayer::Triangles);
+            INC_DWORD_STAT_BY(STAT_DungeonTrianglesRemoved, TriangleErased.Num());
+            INC_DWORD_STAT_BY(STAT_DungeonTrianglesCreated, Boundary.Num());
 
             UE_LOG(LogTemp, Display, TEXT("[Step %d] New triangles created: %d"), CurrentPointIndex, Boundary.Num());
             CurrentLittleStep = 0;
@@ -938,11 +1529,9 @@ void URoomManager::StepByStepPrim(TSubclassOf<ARoomParent> RoomP)
 
 		CreatePath(RoomP);          // -> fills FirstPath
 		bMSTInitialized = true;
+		RedrawStableState();
 	}
 
-	for (const FTriangleEdge& Edge : FirstPath)
-		Edge.DrawEdge(GetWorld(), FColor::Cyan);
-
 	UE_LOG(LogTemp, Display, TEXT("[Prim] %d edges displayed."), FirstPath.Num());
 
 	CurrentStep++;
@@ -961,8 +1550,7 @@ void URoomManager::StepByStepEvolvePath()
 	}
 
 	EvolvePath();
-	for (const FTriangleEdge& Edge : EvolvedPath)
-		Edge.DrawEdge(GetWorld(), FColor::Green);
+	RedrawStableState();
 
 	UE_LOG(LogTemp, Display, TEXT("[Path] L-shaped paths drawn."));
 	CurrentStep++;
@@ -995,14 +1583,26 @@ void URoomManager::ResetStepByStep()
 	StepRunId++;
 
 	// IMPORTANT: Clear visual caches but don't destroy dungeon data
-	FlushPersistentDebugLines(GetWorld());
+	ClearDrawAll();
+}
+
+void URoomManager::TestCircumcircles(const FVector& Point)
+{
+	// One batched, exact Delaunay test of the point against every current triangle
+	CircumcircleBatch.Reset(AllTriangles.Num());
+	for (const FTriangle& Tri : AllTriangles)
+	{
+		CircumcircleBatch.Add(FVector2D(Tri.PointA), FVector2D(Tri.PointB), FVector2D(Tri.PointC));
+	}
+	CircumcircleBatch.TestPoint(FVector2D(Point), InCircumcircle);
+	INC_DWORD_STAT_BY(STAT_DungeonInCircleTests, AllTriangles.Num());
 }
 
 void URoomManager::RedrawStableState()
 {
-	// Useful for repainting after flush: redraw what's already validated
-	for (const FTriangle& T : AllTriangles)           T.DrawTriangle(GetWorld(), FColor(0,255,0));
-	for (const FTriangleEdge& E : FirstPath)          E.DrawEdge(GetWorld(), FColor::Cyan);
-	for (const FTriangleEdge& E : EvolvedPath)        E.DrawEdge(GetWorld(), FColor::Green);
+	// Shows again what's already validated, the layers are only rebuilt when their arrays change
+	ShowDebugLayer(EDungeonDebugLayer::Triangles);
+	ShowDebugLayer(EDungeonDebugLayer::Path);
+	ShowDebugLayer(EDungeonDebugLayer::Corridors);
 }
 
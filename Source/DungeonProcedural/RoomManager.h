@@ -4,10 +4,35 @@
 
 #include "CoreMinimal.h"
 #include "DungeonProcedural/ConfigRoomDataAsset.h"
+#include "DungeonProcedural/DungeonActorPool.h"
+#include "DungeonProcedural/DungeonCorridorRuns.h"
+#include "DungeonProcedural/DungeonDebugDrawComponent.h"
+#include "DungeonProcedural/DungeonGenerator.h"
+#include "DungeonProcedural/DungeonLayout.h"
+#include "DungeonProcedural/DungeonLayoutCache.h"
+#include "DungeonProcedural/DungeonOccupancyGrid.h"
+#include "DungeonProcedural/GeometryPredicates.h"
 #include "DungeonProcedural/Triangle.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "RoomManager.generated.h"
 
+class UHierarchicalInstancedStaticMeshComponent;
+class UMaterialInterface;
+class UStaticMesh;
+
+// Progress in [0, 1] of the async generation RunId
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDungeonGenerationProgress, int32, RunId, float, Progress);
+
+// bCompleted is false if the generation was cancelled
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnDungeonGenerationFinished, int32, RunId, bool, bCompleted);
+
+// Background generation shared by the worker thread and the game thread
+struct FDungeonAsyncJob
+{
+	int32 RunId = 0;
+	std::atomic<bool> bCancelled = false;
+};
+
 /**
  * World Subsystem responsible for procedural dungeon generation.
  * Handles triangulation, room spawning, overlap resolution, and path creation.
@@ -26,8 +51,113 @@ public:
 	TArray<AActor*> OtherActorsToClear;
 	
 	// Main entry point: generates a complete dungeon with specified number and types of rooms
+	// The same Seed and room types always give the same rooms, a negative Seed picks a random one
+	UFUNCTION(BlueprintCallable)
+	void GenerateMap(int NbRoom, const TArray<FRoomType>& RoomTypes, int32 Seed = -1);
+
+	// Runs the whole pipeline headless, then spawns only the kept rooms and the corridors
+	UFUNCTION(BlueprintCallable)
+	void GenerateDungeon(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, int32 Seed = -1);
+
+	// Same as GenerateDungeon, but the headless pipeline runs on a worker thread and only the spawn
+	// happens on the game thread. Returns the RunId passed to OnGenerationProgress / OnGenerationFinished.
+	// ClearAll, GenerateMap or another generation cancels it.
+	UFUNCTION(BlueprintCallable)
+	int32 GenerateDungeonAsync(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, int32 Seed = -1);
+
+	// Drops the running async generation, if any
 	UFUNCTION(BlueprintCallable)
-	void GenerateMap(int NbRoom, TArray<FRoomType> RoomTypes);
+	void CancelAsyncGeneration();
+
+	UFUNCTION(BlueprintPure)
+	bool IsGeneratingAsync() const;
+
+	// Same as GenerateDungeon, but spread over several frames on the game thread, working at most
+	// TimeSliceBudgetMs per frame and without any debug drawing. Returns the RunId passed to
+	// OnGenerationProgress / OnGenerationFinished. ClearAll, GenerateMap or another generation cancels it.
+	UFUNCTION(BlueprintCallable)
+	int32 StartTimeSlicedGeneration(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, TSubclassOf<AActor> CorridorBP, float BudgetMs = 4.f, int32 Seed = -1);
+
+	// Stops the time-sliced generation, the actors spawned so far stay until ClearAll
+	UFUNCTION(BlueprintCallable)
+	void CancelTimeSlicedGeneration();
+
+	UFUNCTION(BlueprintPure)
+	bool IsGeneratingTimeSliced() const;
+
+	// Stage the time-sliced generation is working on, empty when none is running
+	UFUNCTION(BlueprintPure)
+	FString GetTimeSlicedStage() const;
+
+	// Estimated completion of the time-sliced generation in [0, 1]
+	UFUNCTION(BlueprintPure)
+	float GetTimeSlicedProgress() const;
+
+	// Work allowed per frame to the time-sliced generation, can be changed while it runs
+	UPROPERTY(BlueprintReadWrite)
+	float TimeSliceBudgetMs = 4.f;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnDungeonGenerationProgress OnGenerationProgress;
+
+	UPROPERTY(BlueprintAssignable)
+	FOnDungeonGenerationFinished OnGenerationFinished;
+
+	// Splits large triangulations across worker threads, the triangles are the same either way
+	UPROPERTY(BlueprintReadWrite)
+	bool bParallelTriangulation = true;
+
+	// Routes corridors around the primary rooms instead of random L-shapes, see FDungeonCorridorRouter
+	UPROPERTY(BlueprintReadWrite)
+	bool bRouteCorridors = false;
+
+	// GenerateMap and every GenerateDungeon variant reuse the layouts of identical earlier requests
+	UPROPERTY(BlueprintReadWrite)
+	bool bUseLayoutCache = true;
+
+	// Cached layouts are also written to this directory and read back by later sessions, empty keeps them in memory only
+	UFUNCTION(BlueprintCallable)
+	void SetLayoutCacheDirectory(const FString& Directory);
+
+	UFUNCTION(BlueprintCallable)
+	void EmptyLayoutCache();
+
+	UFUNCTION(BlueprintPure)
+	FDungeonLayoutCacheStats GetLayoutCacheStats() const;
+
+	// Seed actually used by the last GenerateMap / GenerateDungeon, replays the same dungeon
+	UFUNCTION(BlueprintPure)
+	int32 GetLastSeed() const { return LastSeed; }
+
+	// Writes the current layout and its seed to a binary layout file
+	UFUNCTION(BlueprintCallable)
+	bool SaveLayout(const FString& Filename) const;
+
+	// Spawns a layout saved by SaveLayout without running any generation stage
+	// The rooms are spawned straight from the memory-mapped file.
+	UFUNCTION(BlueprintCallable)
+	bool LoadLayout(const FString& Filename, const TArray<FRoomType>& RoomTypes, TSubclassOf<AActor> CorridorBP);
+
+	// Result of the last headless generation
+	const FDungeonLayout& GetLayout() const { return Layout; }
+
+	// Kept rooms and corridors of the current layout, one bit per cell and per layer
+	const FDungeonOccupancyGrid& GetOccupancyGrid() const { return OccupancyGrid; }
+
+	// Cell size of the occupancy grid, 0 picks one from the room sizes, applies to the next layout
+	UPROPERTY(BlueprintReadWrite)
+	float OccupancyCellSize = 0.f;
+
+	// Constant-time lookups in the occupancy grid, without any actor or collision query
+	// A location within one cell of a room or a corridor also counts as on it.
+	UFUNCTION(BlueprintPure)
+	bool IsRoomAt(const FVector& Location) const;
+
+	UFUNCTION(BlueprintPure)
+	bool IsCorridorAt(const FVector& Location) const;
+
+	// Converts Blueprint room types into the plain settings used by FDungeonGenerator
+	static FDungeonGenerationSettings MakeGenerationSettings(int NbRoom, const TArray<FRoomType>& RoomTypes, TSubclassOf<ARoomParent> RoomP, TSubclassOf<ARoomParent> RoomS, int32 Seed);
 
 	// Creates the super-triangle that encompasses all rooms for Delaunay triangulation
 	UFUNCTION(BlueprintCallable)
@@ -47,6 +177,34 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	void SpawnConnectionModules(TSubclassOf<AActor> CorridorBP);
+
+	// Spawns one corridor per maximal straight run instead of one per segment, see FDungeonCorridorRuns
+	UPROPERTY(BlueprintReadWrite)
+	bool bMergeCorridors = true;
+
+	// Points where three or four corridors meet, found when the corridors were last spawned
+	// Empty unless bMergeCorridors is set.
+	UFUNCTION(BlueprintPure)
+	TArray<FVector> GetCorridorJunctions() const;
+
+	// Instanced alternative to SpawnConnectionModules: every corridor segment becomes one instance of
+	// CorridorMesh in a single component, stretched along X by segment length / MeshLength
+	UFUNCTION(BlueprintCallable)
+	void SpawnInstancedConnectionModules(UStaticMesh* CorridorMesh, UMaterialInterface* CorridorMaterial = nullptr, float MeshLength = 100.f);
+
+	// Every GenerateDungeon variant and LoadLayout spawn the corridors through SpawnInstancedConnectionModules
+	// with the mesh below instead of spawning CorridorBP actors
+	UPROPERTY(BlueprintReadWrite)
+	bool bInstancedCorridors = false;
+
+	UPROPERTY(BlueprintReadWrite)
+	UStaticMesh* InstancedCorridorMesh = nullptr;
+
+	UPROPERTY(BlueprintReadWrite)
+	UMaterialInterface* InstancedCorridorMaterial = nullptr;
+
+	UPROPERTY(BlueprintReadWrite)
+	float InstancedCorridorMeshLength = 100.f;
 	
 	// Removes secondary rooms that don't intersect with corridor paths
 	UFUNCTION(BlueprintCallable)
@@ -74,12 +232,30 @@ public:
 	void ResolveRoomOverlaps(TArray<ARoomParent*>& SpawnedActors);
 
 
+	// Shows the triangles only
 	void DrawAll();
+
+	// Hides the triangle, path and corridor layers and clears the step highlights
 	void ClearDrawAll();
 
+	// Retained debug lines of the triangles, paths and corridors, created on first use
+	UFUNCTION(BlueprintCallable)
+	UDungeonDebugDrawComponent* GetDebugDraw();
+
 	UFUNCTION(BlueprintCallable)
 	void ClearAll();
 
+	// Spawns hidden actors of this class ahead of time so the next generations reuse them
+	UFUNCTION(BlueprintCallable)
+	void PrewarmActorPool(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	// Destroys the actors waiting in the pool
+	UFUNCTION(BlueprintCallable)
+	void EmptyActorPool();
+
+	UFUNCTION(BlueprintCallable)
+	FDungeonActorPoolStats GetActorPoolStats() const;
+
 	template<typename T>
 	const T* GetAnyElement(const TSet<T>& Set);
 
@@ -101,9 +277,84 @@ public:
 	void ResetStepByStep();
 	void RedrawStableState();
 
+	// Fills InCircumcircle with the Delaunay test of Point against every triangle of AllTriangles
+	void TestCircumcircles(const FVector& Point);
+
 private:
 	bool CheckOverlapping(const UBoxComponent* BoxA, const UBoxComponent* BoxB);
 
+	// Spawns the rooms and corridors of a finished layout and fills the debug arrays
+	void CommitLayout(FDungeonLayout&& InLayout, const TArray<FRoomType>& RoomTypes, TSubclassOf<AActor> CorridorBP);
+
+	// Second half of CommitLayout, once the rooms of Layout are spawned
+	void CommitPaths(TSubclassOf<AActor> CorridorBP);
+
+	// Fills AllTriangles, FirstPath and EvolvedPath from Layout
+	void UpdateDebugArrays();
+
+	// Game thread end of GenerateDungeonAsync, dropped if the job is no longer the current one
+	void CommitAsyncLayout(const TSharedRef<FDungeonAsyncJob>& Job, FDungeonLayout&& InLayout, const TArray<FRoomType>& RoomTypes, TSubclassOf<AActor> CorridorBP);
+
+	// Keeps Seed if it is positive or zero, otherwise draws a new one, and stores it in LastSeed
+	int32 ResolveSeed(int32 Seed);
+
+	// Spawns one actor per kept room of the layout, directly at its final transform
+	void SpawnRooms(const FDungeonLayoutView& InLayout, const TArray<FRoomType>& RoomTypes);
+	void SpawnRoom(const FDungeonLayoutView& InLayout, const TArray<FRoomType>& RoomTypes, int32 RoomIndex);
+
+	// Spawns one corridor actor centered on the edge and stretched along it
+	void SpawnCorridor(const FTriangleEdge& Edge, TSubclassOf<AActor> CorridorBP);
+
+	FDungeonLayout Layout;
+
+	// Rebuilt from Layout whenever one is committed, cached and loaded layouts included
+	FDungeonOccupancyGrid OccupancyGrid;
+
+	// Shared with the async workers, which fill it off the game thread
+	TSharedRef<FDungeonLayoutCache, ESPMode::ThreadSafe> LayoutCache = MakeShared<FDungeonLayoutCache, ESPMode::ThreadSafe>();
+
+	// Seed of the current dungeon, the actor-based stages derive their streams from it
+	int32 LastSeed = 0;
+
+	// Running async generation, reset once committed or cancelled
+	TSharedPtr<FDungeonAsyncJob> AsyncJob;
+	int32 LastAsyncRunId = 0;
+
+	// Time-sliced generation, CurrentStep is the stage and CurrentPointIndex the cursor inside it
+	// Steps past the generator stages spawn the rooms, then the corridors.
+	void TimeSliceTick();
+	bool RunSpawnSliced(int32 Step, double EndTime);
+
+	TUniquePtr<FDungeonGenerator> SlicedGenerator;
+	int32 SlicedRunId = 0;
+	uint64 SlicedCacheKey = 0;
+	FTimerHandle TimeSliceTimer;
+
+	UPROPERTY()
+	TArray<FRoomType> SlicedRoomTypes;
+
+	UPROPERTY()
+	TSubclassOf<AActor> SlicedCorridorBP;
+
+	// Rooms and corridors released by ClearAll, reused by the next generation
+	UPROPERTY()
+	FDungeonActorPool ActorPool;
+
+	// GetAllActorsOfClass without the actors hidden in ActorPool
+	void GetActiveActorsOfClass(TSubclassOf<AActor> ActorClass, TArray<AActor*>& OutActors) const;
+
+	// Owner of the instanced corridors, kept across generations and only emptied by ClearAll
+	UPROPERTY()
+	AActor* CorridorInstancesActor = nullptr;
+
+	UPROPERTY()
+	UHierarchicalInstancedStaticMeshComponent* CorridorInstances = nullptr;
+
+	// EvolvedPath merged into runs, or copied as it is without bMergeCorridors, before any spawning
+	void BuildCorridorsToSpawn();
+	TArray<FTriangleEdge> CorridorsToSpawn;
+	FDungeonCorridorRuns CorridorRuns;
+
 	// Progressive triangulation state variables
 	int CurrentStep = 0;
 	TArray<AActor*> RoomPrincipallist;
@@ -114,6 +365,10 @@ private:
 	bool bMSTInitialized = false;
 	bool bPathsEvolved = false;
 
+	// Batched Delaunay test reused by the step-by-step triangulation
+	FInCircleBatch CircumcircleBatch;
+	TArray<bool> InCircumcircle;
+
 	// Automatic demo state
 	void AutoTick();
 	
@@ -131,7 +386,18 @@ private:
 	FVector MegaTrianglePointC;
 	
 	void RemoveSuperTriangles();
-	
+
+	// Copies AllTriangles, FirstPath or EvolvedPath into their debug layer
+	void RefreshDebugLayer(EDungeonDebugLayer Layer);
+
+	// Shows a layer as it is, without rebuilding it
+	void ShowDebugLayer(EDungeonDebugLayer Layer);
+
+	UPROPERTY()
+	AActor* DebugDrawActor = nullptr;
+
+	UPROPERTY()
+	UDungeonDebugDrawComponent* DebugDraw = nullptr;
 };
 
 struct ToDrawCircle
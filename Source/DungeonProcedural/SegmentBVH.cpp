@@ -0,0 +1,172 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/SegmentBVH.h"
+
+#include "Algo/Sort.h"
+
+void FSegmentBVH::Build(TConstArrayView<FDungeonSegment> Segments)
+{
+	NumBuiltSegments = Segments.Num();
+	Nodes.Reset();
+	AX.Reset();
+	AY.Reset();
+	BX.Reset();
+	BY.Reset();
+	if (Segments.Num() == 0)
+	{
+		return;
+	}
+
+	Order.SetNumUninitialized(Segments.Num());
+	Centroids.SetNumUninitialized(Segments.Num());
+	for (int32 i = 0; i < Segments.Num(); ++i)
+	{
+		Order[i] = i;
+		Centroids[i] = (Segments[i].A + Segments[i].B) * 0.5f;
+	}
+
+	const int32 NumLeaves = (Segments.Num() + LeafSize - 1) / LeafSize;
+	Nodes.Reserve(2 * NumLeaves);
+	AX.Reserve(NumLeaves * LeafSize);
+	AY.Reserve(NumLeaves * LeafSize);
+	BX.Reserve(NumLeaves * LeafSize);
+	BY.Reserve(NumLeaves * LeafSize);
+
+	struct FBuildTask
+	{
+		int32 Node;
+		int32 Begin;
+		int32 End;
+	};
+	TArray<FBuildTask, TInlineAllocator<64>> Tasks;
+	Nodes.AddUninitialized();
+	Tasks.Add({0, 0, Segments.Num()});
+
+	while (Tasks.Num() > 0)
+	{
+		const FBuildTask Task = Tasks.Pop(EAllowShrinking::No);
+		const int32 Count = Task.End - Task.Begin;
+
+		FVector2f Min = FVector2f::Min(Segments[Order[Task.Begin]].A, Segments[Order[Task.Begin]].B);
+		FVector2f Max = FVector2f::Max(Segments[Order[Task.Begin]].A, Segments[Order[Task.Begin]].B);
+		FVector2f CentroidMin = Centroids[Order[Task.Begin]];
+		FVector2f CentroidMax = CentroidMin;
+		for (int32 i = Task.Begin + 1; i < Task.End; ++i)
+		{
+			const FDungeonSegment& Segment = Segments[Order[i]];
+			Min = FVector2f::Min(Min, FVector2f::Min(Segment.A, Segment.B));
+			Max = FVector2f::Max(Max, FVector2f::Max(Segment.A, Segment.B));
+			CentroidMin = FVector2f::Min(CentroidMin, Centroids[Order[i]]);
+			CentroidMax = FVector2f::Max(CentroidMax, Centroids[Order[i]]);
+		}
+
+		FNode& Node = Nodes[Task.Node];
+		Node.Min = Min;
+		Node.Max = Max;
+
+		if (Count <= LeafSize)
+		{
+			Node.First = AX.Num() / LeafSize;
+			Node.Count = Count;
+
+			// Pad with copies of the last segment, they never change the result
+			for (int32 Lane = 0; Lane < LeafSize; ++Lane)
+			{
+				const FDungeonSegment& Segment = Segments[Order[Task.Begin + FMath::Min(Lane, Count - 1)]];
+				AX.Add(Segment.A.X);
+				AY.Add(Segment.A.Y);
+				BX.Add(Segment.B.X);
+				BY.Add(Segment.B.Y);
+			}
+			continue;
+		}
+
+		// Median split along the longest axis of the centroids, rounded so the left side fills whole leaves
+		const int32 Axis = CentroidMax.X - CentroidMin.X >= CentroidMax.Y - CentroidMin.Y ? 0 : 1;
+		Algo::SortBy(MakeArrayView(Order.GetData() + Task.Begin, Count), [this, Axis](int32 Segment) { return Centroids[Segment][Axis]; });
+		const int32 Mid = Task.Begin + (Count / 2 + LeafSize - 1) / LeafSize * LeafSize;
+
+		// Node may dangle once Nodes grows
+		const int32 Children = Nodes.AddUninitialized(2);
+		Nodes[Task.Node].First = Children;
+		Nodes[Task.Node].Count = 0;
+		Tasks.Add({Children, Task.Begin, Mid});
+		Tasks.Add({Children + 1, Mid, Task.End});
+	}
+}
+
+bool FSegmentBVH::IntersectsBox(const FVector2f& Center, const FVector2f& Extent, int32* NumSegmentTests) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return false;
+	}
+
+	const FVector2f BoxMin = Center - Extent;
+	const FVector2f BoxMax = Center + Extent;
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(0);
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(EAllowShrinking::No)];
+		if (Node.Min.X > BoxMax.X || Node.Max.X < BoxMin.X || Node.Min.Y > BoxMax.Y || Node.Max.Y < BoxMin.Y)
+		{
+			continue;
+		}
+
+		if (Node.Count > 0)
+		{
+			const int32 Lane = Node.First * LeafSize;
+			if (NumSegmentTests)
+			{
+				*NumSegmentTests += Node.Count;
+			}
+			if (IntersectBox4(&AX[Lane], &AY[Lane], &BX[Lane], &BY[Lane], Center, Extent) != 0)
+			{
+				return true;
+			}
+		}
+		else
+		{
+			Stack.Add(Node.First);
+			Stack.Add(Node.First + 1);
+		}
+	}
+	return false;
+}
+
+int32 FSegmentBVH::IntersectBox4(const float* AX, const float* AY, const float* BX, const float* BY, const FVector2f& Center, const FVector2f& Extent)
+{
+	const VectorRegister4Float CenterX = VectorSetFloat1(Center.X);
+	const VectorRegister4Float CenterY = VectorSetFloat1(Center.Y);
+	const VectorRegister4Float ExtentX = VectorSetFloat1(Extent.X);
+	const VectorRegister4Float ExtentY = VectorSetFloat1(Extent.Y);
+
+	const VectorRegister4Float PointAX = VectorLoad(AX);
+	const VectorRegister4Float PointAY = VectorLoad(AY);
+	const VectorRegister4Float PointBX = VectorLoad(BX);
+	const VectorRegister4Float PointBY = VectorLoad(BY);
+
+	// Slabs of the box against the segment bounds
+	VectorRegister4Float Mask = VectorBitwiseAnd(
+		VectorCompareLE(VectorMin(PointAX, PointBX), VectorAdd(CenterX, ExtentX)),
+		VectorCompareGE(VectorMax(PointAX, PointBX), VectorSubtract(CenterX, ExtentX)));
+	Mask = VectorBitwiseAnd(Mask, VectorBitwiseAnd(
+		VectorCompareLE(VectorMin(PointAY, PointBY), VectorAdd(CenterY, ExtentY)),
+		VectorCompareGE(VectorMax(PointAY, PointBY), VectorSubtract(CenterY, ExtentY))));
+
+	// Box projected on the segment normal must contain the segment line
+	const VectorRegister4Float DirectionX = VectorSubtract(PointBX, PointAX);
+	const VectorRegister4Float DirectionY = VectorSubtract(PointBY, PointAY);
+	const VectorRegister4Float Distance = VectorAbs(VectorSubtract(
+		VectorMultiply(DirectionX, VectorSubtract(CenterY, PointAY)),
+		VectorMultiply(DirectionY, VectorSubtract(CenterX, PointAX))));
+	const VectorRegister4Float Radius = VectorAdd(
+		VectorMultiply(ExtentX, VectorAbs(DirectionY)),
+		VectorMultiply(ExtentY, VectorAbs(DirectionX)));
+	Mask = VectorBitwiseAnd(Mask, VectorCompareLE(Distance, Radius));
+
+	return VectorMaskBits(Mask);
+}
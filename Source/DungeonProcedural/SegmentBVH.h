@@ -0,0 +1,54 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DungeonProcedural/DungeonLayout.h"
+
+// Bounding volume hierarchy over 2D corridor segments
+// Leaves hold up to four segments stored as structure-of-arrays, so a box is
+// tested against a whole leaf with a single SIMD kernel call.
+// Queries are const and can run from several threads at once.
+class DUNGEONPROCEDURAL_API FSegmentBVH
+{
+public:
+	static constexpr int32 LeafSize = 4;
+
+	// Rebuilds the hierarchy, buffers are kept between builds
+	void Build(TConstArrayView<FDungeonSegment> Segments);
+
+	// True if at least one segment touches the box (Extent is the half size)
+	// NumSegmentTests, if given, is increased by the number of segments tested against the box.
+	bool IntersectsBox(const FVector2f& Center, const FVector2f& Extent, int32* NumSegmentTests = nullptr) const;
+
+	int32 NumSegments() const { return NumBuiltSegments; }
+
+	// Tests one box against four segments given as coordinate arrays
+	// Returns one bit per lane, set if that segment touches the box.
+	// Same result as FDungeonGenerator::IsSegmentIntersectingBox, without any division:
+	// the box must overlap the segment bounds and the segment line must cross the box.
+	static int32 IntersectBox4(const float* AX, const float* AY, const float* BX, const float* BY, const FVector2f& Center, const FVector2f& Extent);
+
+private:
+	struct FNode
+	{
+		FVector2f Min;
+		FVector2f Max;
+
+		// Inner node: children are Nodes[First] and Nodes[First + 1], Count is 0
+		// Leaf: lanes LeafSize * First .. LeafSize * First + 3, Count is the number of real segments
+		int32 First;
+		int32 Count;
+	};
+
+	TArray<FNode> Nodes;
+
+	// Segment coordinates in leaf order, each leaf padded to LeafSize lanes
+	TArray<float> AX, AY, BX, BY;
+
+	// Build scratch
+	TArray<int32> Order;
+	TArray<FVector2f> Centroids;
+
+	int32 NumBuiltSegments = 0;
+};
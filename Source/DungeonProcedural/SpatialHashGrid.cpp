@@ -0,0 +1,71 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DungeonProcedural/SpatialHashGrid.h"
+
+void FSpatialHashGrid::Build(TConstArrayView<FVector2f> Centers, TConstArrayView<FVector2f> Extents, float InCellSize)
+{
+	check(Centers.Num() == Extents.Num());
+
+	CellSize = FMath::Max(InCellSize, UE_KINDA_SMALL_NUMBER);
+	InvCellSize = 1.f / CellSize;
+
+	const int32 NumItems = Centers.Num();
+	ItemMinCells.SetNumUninitialized(NumItems);
+	ItemMaxCells.SetNumUninitialized(NumItems);
+
+	int32 NumEntries = 0;
+	for (int32 Item = 0; Item < NumItems; ++Item)
+	{
+		ItemMinCells[Item] = GetCell(Centers[Item] - Extents[Item]);
+		ItemMaxCells[Item] = GetCell(Centers[Item] + Extents[Item]);
+		NumEntries += (ItemMaxCells[Item].X - ItemMinCells[Item].X + 1) * (ItemMaxCells[Item].Y - ItemMinCells[Item].Y + 1);
+	}
+
+	const uint32 NumBuckets = FMath::RoundUpToPowerOfTwo(uint32(FMath::Max(NumEntries, 16)));
+	BucketMask = NumBuckets - 1;
+
+	// Counting sort of the (bucket, item) pairs, an item whose cells share a bucket is stored there once
+	// Items go in one after the other, so a repeat is always the last item added to the bucket.
+	BucketStarts.Reset(NumBuckets + 1);
+	BucketStarts.AddZeroed(NumBuckets + 1);
+	BucketLastItems.Reset(NumBuckets);
+	BucketLastItems.Init(INDEX_NONE, NumBuckets);
+	for (int32 Item = 0; Item < NumItems; ++Item)
+	{
+		for (int32 CellY = ItemMinCells[Item].Y; CellY <= ItemMaxCells[Item].Y; ++CellY)
+		{
+			for (int32 CellX = ItemMinCells[Item].X; CellX <= ItemMaxCells[Item].X; ++CellX)
+			{
+				const uint32 Bucket = GetBucket(CellX, CellY);
+				if (BucketLastItems[Bucket] != Item)
+				{
+					BucketLastItems[Bucket] = Item;
+					++BucketStarts[Bucket + 1];
+				}
+			}
+		}
+	}
+	for (uint32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+	{
+		BucketStarts[Bucket + 1] += BucketStarts[Bucket];
+	}
+
+	Items.SetNumUninitialized(BucketStarts[NumBuckets]);
+	BucketCursors.Reset(NumBuckets);
+	BucketCursors.Append(BucketStarts.GetData(), NumBuckets);
+	for (int32 Item = 0; Item < NumItems; ++Item)
+	{
+		for (int32 CellY = ItemMinCells[Item].Y; CellY <= ItemMaxCells[Item].Y; ++CellY)
+		{
+			for (int32 CellX = ItemMinCells[Item].X; CellX <= ItemMaxCells[Item].X; ++CellX)
+			{
+				const uint32 Bucket = GetBucket(CellX, CellY);
+				if (BucketCursors[Bucket] == BucketStarts[Bucket] || Items[BucketCursors[Bucket] - 1] != Item)
+				{
+					Items[BucketCursors[Bucket]++] = Item;
+				}
+			}
+		}
+	}
+}
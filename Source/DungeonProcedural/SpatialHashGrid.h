@@ -0,0 +1,81 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Uniform grid broad phase over axis-aligned boxes
+// Cells are hashed into a flat bucket array built with a counting sort, so a
+// rebuild costs two linear passes and no per-cell allocation.
+// Queries are const and can run from several threads at once.
+class DUNGEONPROCEDURAL_API FSpatialHashGrid
+{
+public:
+	// Rebuilds the grid from boxes given as center + half size
+	void Build(TConstArrayView<FVector2f> Centers, TConstArrayView<FVector2f> Extents, float InCellSize);
+
+	// Calls Visitor(ItemIndex) exactly once for every item sharing a cell with the box [Min, Max]
+	// Items are candidates only, the caller does the exact test
+	// Build stores an item once per bucket, and only its reporting cell visits it.
+	template<typename VisitorType>
+	void Query(const FVector2f& Min, const FVector2f& Max, VisitorType&& Visitor) const
+	{
+		if (Items.Num() == 0)
+		{
+			return;
+		}
+
+		const FIntPoint QueryMin = GetCell(Min);
+		const FIntPoint QueryMax = GetCell(Max);
+		for (int32 CellY = QueryMin.Y; CellY <= QueryMax.Y; ++CellY)
+		{
+			for (int32 CellX = QueryMin.X; CellX <= QueryMax.X; ++CellX)
+			{
+				const uint32 Bucket = GetBucket(CellX, CellY);
+				for (int32 Entry = BucketStarts[Bucket]; Entry < BucketStarts[Bucket + 1]; ++Entry)
+				{
+					const int32 Item = Items[Entry];
+					const FIntPoint& ItemMin = ItemMinCells[Item];
+					const FIntPoint& ItemMax = ItemMaxCells[Item];
+
+					// Skip hash collisions, and report each item from a single cell only
+					if (CellX < ItemMin.X || CellX > ItemMax.X || CellY < ItemMin.Y || CellY > ItemMax.Y
+						|| CellX != FMath::Max(ItemMin.X, QueryMin.X) || CellY != FMath::Max(ItemMin.Y, QueryMin.Y))
+					{
+						continue;
+					}
+					Visitor(Item);
+				}
+			}
+		}
+	}
+
+	float GetCellSize() const { return CellSize; }
+
+	FIntPoint GetCell(const FVector2f& Point) const
+	{
+		return FIntPoint(FMath::FloorToInt32(Point.X * InvCellSize), FMath::FloorToInt32(Point.Y * InvCellSize));
+	}
+
+private:
+	uint32 GetBucket(int32 CellX, int32 CellY) const
+	{
+		return ((uint32(CellX) * 73856093u) ^ (uint32(CellY) * 19349663u)) & BucketMask;
+	}
+
+	float CellSize = 1.f;
+	float InvCellSize = 1.f;
+	uint32 BucketMask = 0;
+
+	// Items of bucket B are Items[BucketStarts[B]] .. Items[BucketStarts[B + 1] - 1]
+	TArray<int32> BucketStarts;
+	TArray<int32> Items;
+
+	// Fill positions of the counting sort and last item counted per bucket, kept so rebuilds reuse the memory
+	TArray<int32> BucketCursors;
+	TArray<int32> BucketLastItems;
+
+	// Cell range covered by each item
+	TArray<FIntPoint> ItemMinCells;
+	TArray<FIntPoint> ItemMaxCells;
+};
@@ -1,34 +1,28 @@
 ﻿// Fill out your copyright notice in the Description page of Project Settings.
 #include "DungeonProcedural/Triangle.h"
 
+#include "DungeonProcedural/GeometryPredicates.h"
 #include "MathUtil.h"
 #include "ViewportInteractionTypes.h"
 
-FTriangle::FTriangle(FVector pointA, FVector pointB, FVector pointC)
-{
-	PointA = pointA;
-	PointB = pointB;
-	PointC = pointC;
-	points.Add(PointA);
-	points.Add(PointB);
-	points.Add(PointC);
-}
+// Copied by value in the triangulation loops, must stay plain data
+static_assert(std::is_trivially_copyable_v<FTriangle> && std::is_trivially_copyable_v<FTriangleEdge>, "Triangle types must not own memory");
 
-TArray<FVector> FTriangle::GetAllPoints() const
+TStaticArray<FVector, 3> FTriangle::GetAllPoints() const
 {
-	TArray<FVector> AllPoints;
-	AllPoints.Add(PointA);
-	AllPoints.Add(PointB);
-	AllPoints.Add(PointC);
+	TStaticArray<FVector, 3> AllPoints;
+	AllPoints[0] = PointA;
+	AllPoints[1] = PointB;
+	AllPoints[2] = PointC;
 	return AllPoints;
 }
 
-TArray<FTriangleEdge> FTriangle::GetEdges() const
+TStaticArray<FTriangleEdge, 3> FTriangle::GetEdges() const
 {
-	TArray<FTriangleEdge> Edges;
-	Edges.Add(FTriangleEdge(PointA, PointB));
-	Edges.Add(FTriangleEdge(PointB, PointC));
-	Edges.Add(FTriangleEdge(PointC, PointA));
+	TStaticArray<FTriangleEdge, 3> Edges;
+	Edges[0] = FTriangleEdge(PointA, PointB);
+	Edges[1] = FTriangleEdge(PointB, PointC);
+	Edges[2] = FTriangleEdge(PointC, PointA);
 	return Edges;
 }
 
@@ -38,7 +32,7 @@ bool FTriangle::CenterCircle(FVector& outCenter) const
 	double D = 2 * (PointA.X * (PointB.Y - PointC.Y) + PointB.X * (PointC.Y - PointA.Y) + PointC.X * (PointA.Y - PointB.Y));
 	if (FMath::IsNearlyZero(D))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Points are collinear!"))
+		// Points are collinear
 		return false;
 	}
     
@@ -72,16 +66,18 @@ float FTriangle::GetArea() const
 
 float FTriangle::GetRayon() const
 {
-	// Calculate circumradius for Delaunay triangulation point-in-circle tests
-	FVector ab = PointB - PointA;
-	FVector bc = PointC - PointB;
-	FVector ca = PointA - PointC;
-
-	float S = GetArea();
-	// Circumradius formula: R = (a*b*c)/(4*Area)
-	float R = ((ab.Length()*bc.Length()*ca.Length())/(2*S))/2;
+	// Distance from the circumcenter to any vertex
+	FVector Center;
+	if (!CenterCircle(Center))
+	{
+		return 0;
+	}
+	return FVector::Dist2D(Center, PointA);
+}
 
-	return R;
+bool FTriangle::IsPointInCircumcircle(const FVector& Point) const
+{
+	return FGeometryPredicates::IsInCircumcircle(FVector2D(PointA), FVector2D(PointB), FVector2D(PointC), FVector2D(Point));
 }
 
 void FTriangle::DrawTriangle(const UWorld* InWorld, FColor ColorToUse) const
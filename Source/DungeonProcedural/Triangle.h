@@ -3,20 +3,28 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
 #include "Triangle.generated.h"
 
+struct FTriangleEdge;
+
 // Triangle structure for Delaunay triangulation
 // Contains three points and geometric calculation methods
+// Trivially copyable, none of its accessors or comparisons touch the heap.
 USTRUCT(BlueprintType)
 struct FTriangle
 {
 	GENERATED_BODY()
 	FTriangle() = default;
-	FTriangle(FVector pointA, FVector pointB, FVector pointC);
+	FTriangle(const FVector& pointA, const FVector& pointB, const FVector& pointC)
+		: PointA(pointA), PointB(pointB), PointC(pointC)
+	{
+	}
 
+	// Same vertices in any order
 	bool operator==(const FTriangle& Other) const
 	{
-		return GetAllPoints().Contains(Other.PointA) && GetAllPoints().Contains(Other.PointB) && GetAllPoints().Contains(Other.PointC);
+		return HasVertex(Other.PointA) && HasVertex(Other.PointB) && HasVertex(Other.PointC);
 	}
 
 	bool operator!=(const FTriangle& Other) const
@@ -33,11 +41,16 @@ struct FTriangle
 	UPROPERTY(EditAnywhere,BlueprintReadWrite)
 	FVector PointC;
 
+	bool HasVertex(const FVector& Point) const
+	{
+		return PointA == Point || PointB == Point || PointC == Point;
+	}
+
 	// Returns all three vertices of the triangle
-	TArray<FVector> GetAllPoints() const;
+	TStaticArray<FVector, 3> GetAllPoints() const;
 
 	// Returns the three edges of the triangle
-	TArray<FTriangleEdge> GetEdges() const;
+	TStaticArray<FTriangleEdge, 3> GetEdges() const;
 
 	// Calculates circumcenter for Delaunay triangulation
 	bool CenterCircle(FVector& outCenter) const;
@@ -45,13 +58,14 @@ struct FTriangle
 	// Calculates triangle area using Heron's formula
 	float GetArea() const;
 
-	// Calculates circumradius for point-in-circle tests
+	// Calculates circumradius (for drawing, use IsPointInCircumcircle for tests)
 	float GetRayon() const;
 
+	// Exact Delaunay test on the XY plane, true if Point is strictly inside the circumcircle
+	bool IsPointInCircumcircle(const FVector& Point) const;
+
 	// Debug visualization in editor
 	void DrawTriangle(const UWorld* InWorld, FColor ColorToUse = FColor(0,255,0)) const;
-private:
-	TArray<FVector> points;
 };
 
 // Line structure for geometric calculations